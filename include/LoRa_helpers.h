@@ -3,7 +3,7 @@
     @file LoRa_helpers.h
     @author Franco Abosso
     @author Julio Donadello
-    @version 1.2 29/03/2021
+    @version 1.3 16/10/2026
 */
 
 /*
@@ -16,60 +16,98 @@ void onReceive(int packetSize) {
     #endif
 
     // Si el tamaño del paquete entrante es nulo,
-    // o si es superior al tamaño reservado para la string incomingFull
+    // si es superior al tamaño del buffer incomingFull
+    // o si el mensaje anterior todavía no fue procesado,
     // salir de la subrutina.
-    if (packetSize == 0 || packetSize > INCOMING_FULL_MAX_SIZE) {
+    if (packetSize == 0 || packetSize > INCOMING_FULL_MAX_SIZE || eventPending(events, EVENT_DOWNLINK)) {
         return;
     }
 
-    // No se puede utilizar readString() en un callback.
-    // Se añaden los bytes uno por uno.
-    while (LoRa.available()) {
-        incomingFull += (char)LoRa.read();
-    }
+    // Se copia el paquete completo con una única lectura en ráfaga del FIFO.
+    size_t incomingLength = LoRa.readBytes((uint8_t*)incomingFull, packetSize);
+    incomingFull[incomingLength] = '\0';
 
-    // Se levanta un flag de finalización de lectura LoRa.
-    incomingFullComplete = true;
+    // Se deja pendiente el evento de finalización de lectura LoRa (en contexto de interrupción).
+    eventSet(events, EVENT_DOWNLINK);
 }
 
-void downlinkObserver() {
-    if (incomingFullComplete) {
-        // Extraer el delimitador ">" para diferenciar el ID del payload.
-        int delimiter = incomingFull.indexOf(greaterThanStr);
+/*
+    onTxDone() es la función por interrupción que se llama cuando
+    el SX1278 termina de transmitir un paquete encolado con LoRa.endPacket(true).
+*/
+void onTxDone() {
+    LoRaTxState = TX_DONE;
+}
 
-        // Obtener el ID de receptor.
-        receiverStr = incomingFull.substring(1, delimiter);
-        int receiverID = receiverStr.toInt();
+/**
+    LoRaTxObserver() se encarga de seguir la transmisión LoRa asíncrona:
+        - si llegó la interrupción TxDone, vuelve a poner al SX1278 en modo recepción
+          (que powerObserver() cierra luego de LORA_RX_WINDOW ms),
+        - si pasaron más de LORA_TX_TIMEOUT ms sin recibirla, aborta la transmisión
+          y también vuelve a modo recepción.
+    En ambos casos, deja LoRaTxState en TX_IDLE para poder encolar el próximo paquete.
+*/
+void LoRaTxObserver() {
+    if (LoRaTxState == TX_DONE) {
+        #if DEBUG_LEVEL >= 2
+            Serial.println("Payload LoRa enviado!");
+        #endif
+        radioReceive();
+        LoRaTxState = TX_IDLE;
+    } else if (LoRaTxState == TX_BUSY && millis() - LoRaTxMillis >= LORA_TX_TIMEOUT) {
         #if DEBUG_LEVEL >= 1
-            Serial.print("Receiver: ");
-            Serial.println(receiverID);
+            Serial.println("Timeout de TxDone LoRa!");
         #endif
+        LoRa.idle();
+        radioReceive();
+        LoRaTxState = TX_IDLE;
+    }
+}
 
-        // Si el ID del receptor coincide con nuestro ID o si es un broadcast:
-        if (receiverID == DEVICE_ID || receiverID == BROADCAST_ID) {
-            // Obtiene el payload entrante.
-            incomingPayload = incomingFull.substring(delimiter + 1);
-            #if DEBUG_LEVEL >= 1
-                Serial.println("ID coincide!");
-            #endif
-        } else {
-            #if DEBUG_LEVEL >= 2
-                Serial.println("Descartado por ID!");
-            #endif
-        }
+/**
+    downlinkObserver() es el manejador de EVENT_DOWNLINK: procesa el mensaje LoRa de entrada
+    ("<ID>payload") que guardó onReceive() en incomingFull.
+    Si el ID de receptor coincide con DEVICE_ID o con BROADCAST_ID, copia el payload
+    en incomingPayload y deja pendiente EVENT_COMMAND para que lo ejecute LoRaCmdObserver().
+*/
+void downlinkObserver() {
+    PROFILE(PROBE_LORA);
+    // Extraer el delimitador ">" para diferenciar el ID del payload.
+    char* delimiter = strchr(incomingFull, '>');
+
+    // Obtener el ID de receptor.
+    long receiverID = delimiter != NULL ? atol(incomingFull + 1) : -1;
+    #if DEBUG_LEVEL >= 1
+        Serial.print("Receiver: ");
+        Serial.println(receiverID);
+    #endif
 
-        // Limpiar variables.
-        incomingFullComplete = false;
-        incomingFull = "";
-        receiverStr = "";
+    // Si el ID del receptor coincide con nuestro ID o si es un broadcast:
+    if (receiverID == DEVICE_ID || receiverID == BROADCAST_ID) {
+        // Obtiene el payload entrante.
+        incomingPayload = delimiter + 1;
+        eventPost(EVENT_COMMAND);
+        #if DEBUG_LEVEL >= 1
+            Serial.println("ID coincide!");
+        #endif
+    } else {
+        #if DEBUG_LEVEL >= 2
+            Serial.println("Descartado por ID!");
+        #endif
     }
+
+    // Liberar el buffer para el próximo mensaje.
+    eventClear(EVENT_DOWNLINK);
 }
 
 /**
     LoRaInitialize() inicializa el módulo SX1278 con:
         - la frecuencia (LORA_FREQ) y la palabra de sincronización (LORA_SYNC_WORD) indicados en constants.h
+        - la configuración del módem (LORA_SPREADING_FACTOR, LORA_BANDWIDTH, LORA_CODING_RATE,
+          LORA_PREAMBLE_LENGTH y LORA_CRC) con la que airtime_helpers.h verifica el ciclo de trabajo
         - los pines (NSS_PIN, RESET_PIN, DIO0_PIN) indicados en pinout.h,
-    Además, define la función onRecieve como callback del evento onRecieve.
+    Además, define la función onRecieve como callback del evento onRecieve
+    y la función onTxDone como callback del evento onTxDone.
     Si por algún motivo fallara, "cuelga" al programa.
 */
 void LoRaInitialize() {
@@ -81,8 +119,18 @@ void LoRaInitialize() {
         while (1);
     }
     LoRa.setSyncWord(LORA_SYNC_WORD);
+    LoRa.setSpreadingFactor(LORA_SPREADING_FACTOR);
+    LoRa.setSignalBandwidth(LORA_BANDWIDTH);
+    LoRa.setCodingRate4(LORA_CODING_RATE);
+    LoRa.setPreambleLength(LORA_PREAMBLE_LENGTH);
+    #if LORA_CRC
+        LoRa.enableCrc();
+    #else
+        LoRa.disableCrc();
+    #endif
     LoRa.onReceive(onReceive);
-    LoRa.receive();
+    LoRa.onTxDone(onTxDone);
+    radioReceive();
 
     #if DEBUG_LEVEL >= 1
         Serial.println("LoRa initialized OK.");
@@ -90,19 +138,14 @@ void LoRaInitialize() {
 }
 
 /**
-    reserveMemory() reserva memoria para las Strings.
+    reserveMemory() reserva memoria para la String de comandos entrantes (incomingPayload).
+    Ni la transmisión ni la interrupción de recepción utilizan Strings
+    (ver composeLoRaPayload() y onReceive()).
     En caso de quedarse sin memoria, alerta por puerto serial
     e inicia una alerta de falla
 */
 void reserveMemory() {
-    receiverStr.reserve(DEVICE_ID_MAX_SIZE);
-    incomingPayload.reserve(INCOMING_PAYLOAD_MAX_SIZE);
-    incomingFull.reserve(INCOMING_FULL_MAX_SIZE);
-    latStr.reserve(5 + GPS_DECIMAL_POSITIONS);
-    lngStr.reserve(5 + GPS_DECIMAL_POSITIONS);
-    altStr.reserve(5);
-
-    if (!outcomingFull.reserve(MAX_SIZE_OUTCOMING_LORA_REPORT)) {
+    if (!incomingPayload.reserve(INCOMING_PAYLOAD_MAX_SIZE)) {
         #if DEBUG_LEVEL >= 1
             Serial.println("Strings out of memory!");
         #endif
@@ -112,92 +155,488 @@ void reserveMemory() {
 }
 
 /**
-    composeLoRaPayload() se encarga de crear la string de carga útil de LoRa,
-    a partir de los estados actuales de los sensores.
+    printCentiamps() escribe sobre out una corriente en centiamperes (ver binaryCurrent())
+    en amperes, con 2 decimales ("nan" si es BINARY_PAYLOAD_NO_CURRENT).
+    @param centiamps Corriente (en centiamperes).
+    @param &out Destino de la corriente.
+    @return Cantidad de bytes escritos.
+*/
+size_t printCentiamps(uint16_t centiamps, Print& out) {
+    if (centiamps == BINARY_PAYLOAD_NO_CURRENT) {
+        return out.print(NAN);
+    }
+    return out.print(centiamps / 100.0);
+}
+
+/**
+    printLoRaWindow() escribe sobre out los campos de una ventana de medición
+    (corriente, lluvia y combustible/capacidad) con el formato del payload ASCII.
+    Con REPORT_CURRENT_STATS, la corriente media va seguida de la mínima, la máxima
+    y el desvío estándar ("current=0.65&imin=0.60&imax=0.71&isd=0.03").
+    @param current Corriente de la ventana (ver reduceCurrent()).
+    @param raindrop Resultado de la votación de lluvia de la ventana (ver reportedRaindrop()).
+    @param gas Combustible de la ventana (ver reportedGas()).
+    @param &out Destino de los campos.
+    @return Cantidad de bytes escritos.
+*/
+size_t printLoRaWindow(const WindowCurrent& current, int raindrop, float gas, Print& out) {
+    size_t written = out.print("current=");
+    written += out.print(current.mean);
+
+    #if REPORT_CURRENT_STATS
+        written += out.print("&imin=");
+        written += printCentiamps(current.min, out);
+        written += out.print("&imax=");
+        written += printCentiamps(current.max, out);
+        written += out.print("&isd=");
+        written += printCentiamps(current.stddev, out);
+    #endif
+
+    written += out.print("&raindrops=");
+    written += out.print(raindrop);
+
+    written += out.print("&gas=");
+    written += out.print(gas);
+
+    written += out.print("/");
+    #ifdef CAPACIDAD_COMBUSTIBLE
+        written += out.print((int)CAPACIDAD_COMBUSTIBLE);
+    #else
+        written += out.print("***");
+    #endif
+
+    return written;
+}
+
+/**
+    printLoRaHeader() escribe sobre out el identificador de nodo ("<20009>").
+    @param &out Destino del identificador.
+    @return Cantidad de bytes escritos.
+*/
+size_t printLoRaHeader(Print& out) {
+    size_t written = out.print("<");
+    #ifdef DEVICE_ID
+        written += out.print((int)DEVICE_ID);
+    #else
+        written += out.print("***");
+    #endif
+    written += out.print(">");
+
+    return written;
+}
+
+/**
+    printLoRaPosition() escribe sobre out la posición actual ("&lat=...&lng=...&alt=...").
+    @param &out Destino de la posición.
+    @return Cantidad de bytes escritos.
+*/
+size_t printLoRaPosition(Print& out) {
+    size_t written = 0;
+    double lat, lng, alt;
+    if (reportedPosition(lat, lng, alt)) {
+        written += out.print("&lat=");
+        written += out.print(lat, GPS_DECIMAL_POSITIONS);
+        written += out.print("&lng=");
+        written += out.print(lng, GPS_DECIMAL_POSITIONS);
+        written += out.print("&alt=");
+        written += out.print((int)alt);
+    } else {
+        written += out.print("&lat=***&lng=***&alt=***");
+    }
+
+    return written;
+}
+
+/**
+    printLoRaEnergy() escribe sobre out la energía estimada de la última ventana cerrada
+    ("&mj=4321", ver powerCloseCycle()), sólo con REPORT_ENERGY.
+    @param &out Destino de la energía.
+    @return Cantidad de bytes escritos.
+*/
+size_t printLoRaEnergy(Print& out) {
+    size_t written = 0;
+    #if REPORT_ENERGY
+        written += out.print("&mj=");
+        written += out.print(lround(powerLastCycle));
+    #else
+        (void)out;
+    #endif
+
+    return written;
+}
+
+/**
+    printLoRaVcc() escribe sobre out la última tensión de alimentación que midió EmonLib
+    ("&vcc=4987", ver cachedVcc()), sólo con REPORT_VCC y sin CORRIENTE_MOCK. No mide:
+    la tensión se refresca con las mediciones de corriente, cada VCC_REFRESH_TIMEOUT segundos.
+    @param &out Destino de la tensión.
+    @return Cantidad de bytes escritos.
+*/
+size_t printLoRaVcc(Print& out) {
+    size_t written = 0;
+    #if REPORT_VCC && !defined(CORRIENTE_MOCK)
+        if (eMon.vccAvailable()) {
+            written += out.print("&vcc=");
+            written += out.print(eMon.cachedVcc());
+        }
+    #else
+        (void)out;
+    #endif
+
+    return written;
+}
+
+/**
+    composeLoRaPayload() se encarga de escribir la carga útil de LoRa,
+    a partir de los valores de una ventana de medición y de la posición actual.
+    Los campos se formatean uno por uno directamente sobre out (sin Strings ni buffers
+    intermedios), por lo que entre LoRa.beginPacket() y LoRa.endPacket() se escriben
+    directamente en el FIFO del SX1278; con Serial, se imprimen para debug.
     Por ejemplo, si:
         DEVICE_ID = 20009
-        cts = {0.50, 0.80, 0.65}
-        rain = {1, 0, 1, -1}
-        gas = 123.5187
-        CAPACIDAD_COMBUSTIBLE = 150
+        current = 0.65 (media de la ventana)
+        raindrop = 1
+        gas = 6.21
+        CAPACIDAD_COMBUSTIBLE = 12
         GPS.location.lat() = -34.574749127
         GPS.location.lng() = 58.43552318
         GPS.location.alt() = 15.62
-    Entonces, esta función sobreescribe la String a retornar con:
+    Entonces, esta función escribe sobre out:
         "<20009>current=0.65&raindrops=1&gas=6.21/12&lat=-34.57475&lng=58.43552&alt=15"
-    @param cts Array con los valores de medición de corriente.
-    @param rain Array con los valores de medición de lluvia.
-    @param gas Número con coma flotante con la medición de combustible.
-    @param &rtn Dirección de memoria de la String a componer.
+    (con REPORT_ENERGY, seguido de la energía estimada de la ventana, ver printLoRaEnergy(),
+    y con REPORT_VCC, de la tensión de alimentación, ver printLoRaVcc()).
+    @param current Corriente de la ventana (ver reduceCurrent()).
+    @param raindrop Resultado de la votación de lluvia de la ventana (ver reportedRaindrop()).
+    @param gas Combustible de la ventana (ver reportedGas()).
+    @param &out Destino de la carga útil (LoRa, Serial o cualquier otro Print).
+    @return Cantidad de bytes escritos.
 */
-void composeLoRaPayload(float cts[], int rain[], float gas, String& rtn) {
+size_t composeLoRaPayload(const WindowCurrent& current, int raindrop, float gas, Print& out) {
     // Payload LoRA = vector de bytes transmitidos en forma FIFO.
     // | Dev ID | Corriente | Lluvia | Combustible/capacidad | Latitud | Longitud | Altitud |
-    rtn = "<";
-    #ifdef DEVICE_ID
-        rtn += ((int)DEVICE_ID);
-    #else
-        rtn += "***";
+    size_t written = printLoRaHeader(out);
+    written += printLoRaWindow(current, raindrop, gas, out);
+    written += printLoRaPosition(out);
+    written += printLoRaEnergy(out);
+    written += printLoRaVcc(out);
+
+    return written;
+}
+
+/**
+    composeLoRaBatch() se encarga de escribir la carga útil ASCII agrupada, con las
+    ventanas pendientes del anillo (de la más antigua a la más reciente).
+    El encabezado (identificador, cantidad de ventanas y posición actual) se escribe una única vez,
+    y cada ventana lleva los segundos transcurridos hasta el envío ("t=-40").
+    Por ejemplo, con 3 ventanas:
+        "<20009>batch=3&lat=-34.57475&lng=58.43552&alt=15"
+        "|t=-40&current=0.65&raindrops=1&gas=6.21/12"
+        "|t=-20&current=0.70&raindrops=1&gas=6.20/12"
+        "|t=0&current=0.68&raindrops=0&gas=6.20/12"
+    (todo en una única línea).
+    @param &out Destino de la carga útil (LoRa, Serial o cualquier otro Print).
+    @return Cantidad de bytes escritos.
+*/
+size_t composeLoRaBatch(Print& out) {
+    size_t written = printLoRaHeader(out);
+    written += out.print("batch=");
+    written += out.print(batchCount);
+    written += printLoRaPosition(out);
+    written += printLoRaEnergy(out);
+    written += printLoRaVcc(out);
+
+    for (int i = 0; i < batchCount; i++) {
+        int window = batchWindow(i);
+        written += out.print("|t=");
+        written += out.print(-(long)batchWindowAge(i));
+        written += out.print("&");
+        written += printLoRaWindow(batchCurrents[window], batchRaindrops[window], batchGas[window], out);
+    }
+
+    return written;
+}
+
+#if PROFILER
+    /**
+        composeLoRaProfile() escribe sobre out la carga útil del paquete de diagnóstico: por cada
+        sonda del perfilador, su nombre, la cantidad de ejecuciones y los tiempos medio, máximo
+        y peor (en us; ver profiler.h) del período actual. Por ejemplo:
+            "<20009>prof=lp:612034/11/2904/8160,rep:3/1208/3311/3311,cur:90/6710/7020/7020,..."
+        Aun con los valores más largos, no supera los 243 bytes.
+        @param &out Destino de la carga útil.
+        @return Cantidad de bytes escritos.
+    */
+    size_t composeLoRaProfile(Print& out) {
+        size_t written = printLoRaHeader(out);
+        written += out.print("prof=");
+        for (uint8_t i = 0; i < PROFILER_PROBES; i++) {
+            if (i > 0) {
+                written += out.print(",");
+            }
+            written += out.print((const __FlashStringHelper*)profileNames[i]);
+            written += out.print(":");
+            written += out.print(profile[i].count);
+            written += out.print("/");
+            written += out.print(profileMean(profile[i]));
+            written += out.print("/");
+            written += out.print(profile[i].max);
+            written += out.print("/");
+            written += out.print(profile[i].worst);
+        }
+
+        return written;
+    }
+#endif
+
+/**
+    binaryGas() convierte una cantidad de combustible al formato del payload binario.
+    @param gas Combustible (en L).
+    @return Fracción de CAPACIDAD_COMBUSTIBLE (0 a BINARY_PAYLOAD_FUEL_FULL).
+*/
+uint8_t binaryGas(float gas) {
+    float fraction = constrain(gas / float(CAPACIDAD_COMBUSTIBLE), 0.0, 1.0);
+    return (uint8_t)(fraction * BINARY_PAYLOAD_FUEL_FULL + 0.5);
+}
+
+/**
+    binaryHeader() completa el identificador de nodo, la posición actual y el flag stats
+    (REPORT_CURRENT_STATS) de un BinaryPayload.
+    @param &payload Dirección de memoria del BinaryPayload a completar.
+*/
+void binaryHeader(BinaryPayload& payload) {
+    payload.deviceId = (uint16_t)DEVICE_ID;
+    payload.stats = REPORT_CURRENT_STATS;
+
+    double lat, lng, alt;
+    payload.gpsValid = reportedPosition(lat, lng, alt);
+    if (payload.gpsValid) {
+        payload.lat = (int32_t)lround(lat * BINARY_PAYLOAD_GPS_SCALE);
+        payload.lng = (int32_t)lround(lng * BINARY_PAYLOAD_GPS_SCALE);
+        payload.alt = (int16_t)constrain(alt, -32768.0, 32767.0);
+    } else {
+        payload.lat = 0;
+        payload.lng = 0;
+        payload.alt = 0;
+    }
+}
+
+/**
+    composeBinaryPayload() se encarga de crear la carga útil binaria de LoRa
+    (ver binary_payload.h), a partir de los valores de una ventana de medición.
+    Por ejemplo, con los mismos valores que en composeLoRaPayload():
+        DEVICE_ID = 20009                  -> 29 4E
+        corriente = 0.65 A                 -> 41 00
+        lluvia = 1, GPS válido, versión 1  -> 25
+        gas = 6.21 / 12 L                  -> 84
+        lat = -34.57475                    -> 3D 3E CB FF
+        lng = 58.43552                     -> 60 2A 59 00
+        alt = 15 m                         -> 0F 00
+    Con REPORT_CURRENT_STATS, agrega la corriente mínima, la máxima y el desvío estándar.
+    @param current Corriente de la ventana (ver reduceCurrent()).
+    @param raindrop Resultado de la votación de lluvia de la ventana (ver reportedRaindrop()).
+    @param gas Combustible de la ventana (ver reportedGas()).
+    @param rtn Buffer de al menos BINARY_PAYLOAD_STATS_SIZE bytes a componer.
+    @return Cantidad de bytes escritos (BINARY_PAYLOAD_SIZE o BINARY_PAYLOAD_STATS_SIZE).
+*/
+size_t composeBinaryPayload(const WindowCurrent& current, int raindrop, float gas, uint8_t rtn[]) {
+    BinaryPayload payload;
+
+    binaryHeader(payload);
+    payload.current = binaryCurrent(current.mean);
+    #if REPORT_CURRENT_STATS
+        payload.currentMin = current.min;
+        payload.currentMax = current.max;
+        payload.currentStddev = current.stddev;
     #endif
-    rtn += ">";
+    payload.rain = raindrop;
+    payload.gas = binaryGas(gas);
+
+    return encodeBinaryPayload(payload, rtn);
+}
 
-    rtn += "current";
-    rtn += "=";
-    rtn += compressArray(cts, ARRAY_SIZE);
+/**
+    composeBinaryBatch() se encarga de crear la carga útil binaria agrupada de LoRa
+    (ver binary_payload.h), con las ventanas pendientes del anillo.
+    @param rtn Buffer de al menos BINARY_BATCH_STATS_SIZE(batchCount) bytes a componer.
+    @return Cantidad de bytes escritos (BINARY_BATCH_SIZE(batchCount) o BINARY_BATCH_STATS_SIZE(batchCount)).
+*/
+size_t composeBinaryBatch(uint8_t rtn[]) {
+    BinaryPayload header;
+    BinaryBatchWindow windows[LORA_BATCH_MAX];
 
-    rtn += "&";
-    rtn += "raindrops";
-    rtn += "=";
-    #ifndef RAINDROP_MOCK
-        rtn += compressArray(rain, ARRAY_SIZE);
-    #else
-        rtn += ((int)RAINDROP_MOCK);
+    binaryHeader(header);
+    for (int i = 0; i < batchCount; i++) {
+        int window = batchWindow(i);
+        windows[i].age = (uint16_t)min(batchWindowAge(i), 0xFFFFU);
+        windows[i].current = binaryCurrent(batchCurrents[window].mean);
+        #if REPORT_CURRENT_STATS
+            windows[i].currentMin = batchCurrents[window].min;
+            windows[i].currentMax = batchCurrents[window].max;
+            windows[i].currentStddev = batchCurrents[window].stddev;
+        #endif
+        windows[i].rain = batchRaindrops[window];
+        windows[i].gas = binaryGas(batchGas[window]);
+    }
+
+    return encodeBinaryBatch(header, windows, batchCount, rtn);
+}
+
+/**
+    printPayloadHex() imprime por puerto serial una carga útil binaria en hexadecimal.
+    @param payload Bytes a imprimir.
+    @param size Cantidad de bytes.
+*/
+void printPayloadHex(const uint8_t payload[], size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        if (payload[i] < 0x10) {
+            Serial.print("0");
+        }
+        Serial.print(payload[i], HEX);
+    }
+    Serial.println();
+}
+
+/**
+    beginLoRaPacket() comienza un nuevo paquete LoRa, siempre que no haya otro transmitiéndose.
+    Si no puede, quien lo llama decide qué hacer con la carga útil (ver sendLoRaBatch()).
+    @return true si se puede escribir el paquete, false si el SX1278 todavía estaba ocupado.
+*/
+bool beginLoRaPacket() {
+    return LoRaTxState == TX_IDLE && LoRa.beginPacket();
+}
+
+/**
+    endLoRaPacket() encola el paquete LoRa en curso, sin esperar a que termine la transmisión
+    (LoRaTxObserver() vuelve a poner al módulo LoRa en modo recepción).
+    Además, contabiliza su tiempo en el aire en LoRaLastAirtime y LoRaTotalAirtime.
+    @param length Tamaño de la carga útil escrita (en bytes).
+*/
+void endLoRaPacket(size_t length) {
+    LoRaTxState = TX_BUSY;
+    LoRaTxMillis = millis();
+    radioTransmit();
+    LoRa.endPacket(true);
+
+    LoRaLastAirtime = timeOnAir(length);
+    LoRaTotalAirtime += (LoRaLastAirtime + 500) / 1000;
+    #if DEBUG_LEVEL >= 2
+        Serial.print("Tiempo en el aire: ");
+        Serial.print(LoRaLastAirtime / 1000.0);
+        Serial.print(" ms (acumulado: ");
+        Serial.print(LoRaTotalAirtime);
+        Serial.println(" ms)");
+    #endif
+}
+
+/**
+    sendLoRaPayload() compone la carga útil de LoRa de una ventana, en el formato
+    configurado (LORA_PAYLOAD_FORMAT), y encola el paquete.
+    @param current Corriente de la ventana (ver reduceCurrent()).
+    @param raindrop Resultado de la votación de lluvia de la ventana (ver reportedRaindrop()).
+    @param gas Combustible de la ventana (ver reportedGas()).
+    @return true si el paquete fue encolado, false si el SX1278 todavía estaba ocupado.
+*/
+bool sendLoRaPayload(const WindowCurrent& current, int raindrop, float gas) {
+    #if LORA_PAYLOAD_FORMAT == PAYLOAD_FORMAT_BINARY
+        // Compone la carga útil binaria de LoRa (en la pila, sin Strings).
+        uint8_t outcomingBinary[BINARY_PAYLOAD_STATS_SIZE];
+        size_t outcomingLength = composeBinaryPayload(current, raindrop, gas, outcomingBinary);
     #endif
 
-    rtn += "&";
-    rtn += "gas";
-    rtn += "=";
-    #ifndef GAS_MOCK
-        rtn += round2decimals(gas);
+    if (!beginLoRaPacket()) {
+        return false;
+    }
+    #if LORA_PAYLOAD_FORMAT == PAYLOAD_FORMAT_BINARY
+        LoRa.write(outcomingBinary, outcomingLength);
     #else
-        rtn += round2decimals(GAS_MOCK);
+        // La carga útil ASCII se escribe directamente en el FIFO del SX1278.
+        size_t outcomingLength = composeLoRaPayload(current, raindrop, gas, LoRa);
     #endif
+    endLoRaPacket(outcomingLength);
 
-    rtn += "/";
-    #ifdef CAPACIDAD_COMBUSTIBLE
-        rtn += ((int)CAPACIDAD_COMBUSTIBLE);
-    #else
-        rtn += "***";
+    #if DEBUG_LEVEL >= 1
+        Serial.print("Payload LoRa encolado!: ");
+        #if LORA_PAYLOAD_FORMAT == PAYLOAD_FORMAT_BINARY
+            printPayloadHex(outcomingBinary, outcomingLength);
+        #else
+            composeLoRaPayload(current, raindrop, gas, Serial);
+            Serial.println();
+        #endif
     #endif
 
-    #ifndef GPS_MOCK
-        if (GPS.location.isValid()) {
-            latStr = String(GPS.location.lat(), GPS_DECIMAL_POSITIONS);
-            lngStr = String(GPS.location.lng(), GPS_DECIMAL_POSITIONS);
-            altStr = String((int)GPS.altitude.meters());
-        } else {
-            latStr = "***";
-            lngStr = "***";
-            altStr = "***";
+    return true;
+}
+
+/**
+    profileObserver() se encarga de enviar el paquete de diagnóstico del perfilador pedido con
+    el comando LoRa "prof" (ver LoRaCmdObserver()), apenas termina la transmisión en curso.
+    Sólo con PROFILER y PROFILER_UPLINK.
+*/
+void profileObserver() {
+    #if PROFILER && PROFILER_UPLINK
+        if (profileUplinkRequested && LoRaTxState == TX_IDLE && beginLoRaPacket()) {
+            size_t outcomingLength = composeLoRaProfile(LoRa);
+            endLoRaPacket(outcomingLength);
+            profileUplinkRequested = false;
+            #if DEBUG_LEVEL >= 1
+                Serial.print("Diagnóstico LoRa encolado!: ");
+                composeLoRaProfile(Serial);
+                Serial.println();
+            #endif
         }
-    #else
-        latStr = String(GPS_MOCK[0], GPS_DECIMAL_POSITIONS);
-        lngStr = String(GPS_MOCK[1], GPS_DECIMAL_POSITIONS);
-        altStr = String((int)GPS_MOCK[2]);
     #endif
+}
 
-    rtn += "&";
-    rtn += "lat";
-    rtn += "=";
-    rtn += latStr;
+/**
+    sendLoRaBatch() envía en un único paquete todas las ventanas pendientes del anillo
+    y, si pudo encolarlo, vacía el anillo y registra el instante del envío (ver rememberReportSent()).
+    Con una sola ventana pendiente, utiliza la carga útil simple (ver sendLoRaPayload()).
+    Si el SX1278 todavía estaba ocupado, las ventanas quedan en el anillo y se reintentan
+    con la próxima ventana que cierre.
+    @return true si el paquete fue encolado, false si el SX1278 todavía estaba ocupado.
+*/
+bool sendLoRaBatch() {
+    bool queued;
+    if (batchCount == 1) {
+        int window = batchWindow(0);
+        queued = sendLoRaPayload(batchCurrents[window], batchRaindrops[window], batchGas[window]);
+    } else {
+        #if LORA_PAYLOAD_FORMAT == PAYLOAD_FORMAT_BINARY
+            // Compone la carga útil binaria agrupada (en la pila, sin Strings).
+            uint8_t outcomingBinary[BINARY_BATCH_STATS_SIZE(LORA_BATCH_MAX)];
+            size_t outcomingLength = composeBinaryBatch(outcomingBinary);
+        #endif
 
-    rtn += "&";
-    rtn += "lng";
-    rtn += "=";
-    rtn += lngStr;
+        queued = beginLoRaPacket();
+        if (queued) {
+            #if LORA_PAYLOAD_FORMAT == PAYLOAD_FORMAT_BINARY
+                LoRa.write(outcomingBinary, outcomingLength);
+            #else
+                size_t outcomingLength = composeLoRaBatch(LoRa);
+            #endif
+            endLoRaPacket(outcomingLength);
 
-    rtn += "&";
-    rtn += "alt";
-    rtn += "=";
-    rtn += altStr;
+            #if DEBUG_LEVEL >= 1
+                Serial.print("Payload LoRa agrupado encolado!: ");
+                #if LORA_PAYLOAD_FORMAT == PAYLOAD_FORMAT_BINARY
+                    printPayloadHex(outcomingBinary, outcomingLength);
+                #else
+                    composeLoRaBatch(Serial);
+                    Serial.println();
+                #endif
+            #endif
+        }
+    }
+
+    if (queued) {
+        batchCount = 0;
+        rememberReportSent();
+    } else {
+        // Las ventanas siguen en el anillo: se reintenta con el próximo cierre de ventana.
+        #if DEBUG_LEVEL >= 1
+            Serial.print("LoRa ocupado, ventanas pendientes: ");
+            Serial.println(batchCount);
+        #endif
+    }
+    return queued;
 }
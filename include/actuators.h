@@ -3,54 +3,76 @@
     @file actuators.h
     @author Franco Abosso
     @author Julio Donadello
-    @version 1.0 29/03/2021
+    @version 1.1 16/10/2026
 */
 
 /**
-    alertObserver() se encarga de consultar el estado de la variable resetAlert:
-    si existe un pedido de iniciar la alerta, actualiza pitidosRestantes
-    en base a totalPitidos (configurado por startAlert()) y baja el flag de pedido.
-    Luego, si existen pedidos restantes, los realiza en base a tiempoPitido (configurado
-    por startAlert()).
+    toggleBuzzer() es la tarea TASK_BUZZER: invierte el estado del buzzer y, al apagarlo,
+    descuenta un pitido de pitidosRestantes. Al terminar el último pitido, se detiene
+    y baja EVENT_BUZZER (la alerta terminó).
 */
-void alertObserver() {
-    if (resetAlert && pitidosRestantes == 0) {
-        pitidosRestantes = totalPitidos;
-        resetAlert = false;
+void toggleBuzzer() {
+    digitalWrite(BUZZER_PIN, !digitalRead(BUZZER_PIN));
+    if (digitalRead(BUZZER_PIN) == BUZZER_INACTIVO) {
+        pitidosRestantes--;
     }
-    if (pitidosRestantes > 0) {
-        if(runEvery(tiempoPitido, 3)) {
-            digitalWrite(BUZZER_PIN, !digitalRead(BUZZER_PIN));
-            if (digitalRead(BUZZER_PIN) == BUZZER_INACTIVO) {
-                pitidosRestantes--;
-            }
-        }
-    } else {
+    if (pitidosRestantes <= 0) {
+        taskStop(scheduler, TASK_BUZZER);
         digitalWrite(BUZZER_PIN, BUZZER_INACTIVO);
+        eventClear(EVENT_BUZZER);
+    }
+}
+
+/**
+    alertObserver() es el manejador de EVENT_ALERT (pedido de iniciar una alerta):
+    si no hay otra alerta en curso (EVENT_BUZZER), actualiza pitidosRestantes
+    en base a totalPitidos (configurado por startAlert()), cambia el pedido por EVENT_BUZZER y
+    programa la tarea TASK_BUZZER cada tiempoPitido ms (configurado por startAlert()),
+    que realiza los pitidos y detiene la alerta cuando no quedan pitidos restantes.
+*/
+void alertObserver() {
+    if (eventPending(events, EVENT_BUZZER)) {
+        return;
+    }
+    eventClear(EVENT_ALERT);
+    if (totalPitidos > 0) {
+        pitidosRestantes = totalPitidos;
+        eventPost(EVENT_BUZZER);
+        taskStart(scheduler, TASK_BUZZER, toggleBuzzer, tiempoPitido, 0, TASK_BUZZER, millis());
     }
 }
 
 /**
-    LoRaCmdObserver() se encarga de consultar el estado de la variable incomingPayload.
-    Si la variable está vacía, sale de la función.
+    LoRaCmdObserver() es el manejador de EVENT_COMMAND: ejecuta el comando de incomingPayload.
     Si el comando existe dentro del array de comandos conocidos, ejecuta cierta acción.
-    Incluso si no existiera, limpia incomingPayload.
+    Incluso si no existiera, limpia incomingPayload y baja EVENT_COMMAND.
 */
 void LoRaCmdObserver() {
-    if (incomingPayload == "") {
-        return;
+    PROFILE(PROBE_LORA);
+    #if DEBUG_LEVEL >= 1
+        Serial.print("Quiero hacer esto >> ");
+        Serial.println(incomingPayload);
+    #endif
+    if (incomingPayload == knownCommands[0]) {          // knownCommands[0]: startAlert
+        startAlert(750, 10);
+    } else if (incomingPayload.startsWith(knownCommands[1])) {  // knownCommands[1]: batch=N
+        // Ventanas por paquete LoRa, limitadas al rango 1 a LORA_BATCH_MAX.
+        reportBatchSize = constrain(atoi(incomingPayload.c_str() + knownCommands[1].length()), 1, LORA_BATCH_MAX);
+        #if DEBUG_LEVEL >= 1
+            Serial.print("Ventanas por paquete LoRa: ");
+            Serial.println(reportBatchSize);
+        #endif
+    } else if (incomingPayload == knownCommands[2]) {   // knownCommands[2]: prof
+        #if PROFILER && PROFILER_UPLINK
+            profileUplinkRequested = true;
+        #elif DEBUG_LEVEL >= 1
+            Serial.println("Perfilador deshabilitado!");
+        #endif
     } else {
         #if DEBUG_LEVEL >= 1
-            Serial.print("Quiero hacer esto >> ");
-            Serial.println(incomingPayload);
+            Serial.println("Descartado por payload incorrecto!");
         #endif
-        if (incomingPayload == knownCommands[0]) {          // knownCommands[0]: startAlert
-            startAlert(750, 10);
-        } else {
-            #if DEBUG_LEVEL >= 1
-                Serial.println("Descartado por payload incorrecto!");
-            #endif
-        }
-        incomingPayload = "";
     }
+    incomingPayload = "";
+    eventClear(EVENT_COMMAND);
 }
@@ -0,0 +1,269 @@
+/**
+    Header que contiene el motor de muestreo del ADC (ADC_SAMPLING == ADC_SAMPLING_ENGINE).
+    Timer1 dispara una conversión cada 1/ADC_SAMPLE_RATE segundos (auto-trigger por
+    Compare Match B) y la interrupción de fin de conversión guarda el resultado en el anillo
+    del canal convertido, selecciona el siguiente canal de adcChannels y corre OCR1B
+    ADC_TIMER1_STEP ticks: Timer1 cuenta libremente porque la recepción del GPS (gps_uart.h)
+    también lo usa.
+    Así, el programa principal nunca espera una conversión, la tasa de muestreo no depende
+    de lo que tarde loop() y el muestreo continúa mientras se transmite por LoRa o por serie.
+    Con ADC_SAMPLING == ADC_SAMPLING_POLLED, adcRead() es simplemente analogRead().
+    @file adc_engine.h
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.1 16/10/2026
+*/
+
+#if ADC_SAMPLING == ADC_SAMPLING_ENGINE
+
+/**
+    adcChannelOf() obtiene la posición de un pin dentro de adcChannels.
+    @param pin Pin analógico (A0..A7).
+    @return Posición del canal, o -1 si el motor no muestrea ese pin.
+*/
+int adcChannelOf(unsigned int pin) {
+    for (int i = 0; i < ADC_CHANNELS_QTY; i++) {
+        if (adcChannels[i] == pin) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+    adcStore() guarda una muestra recién convertida del canal adcCurrent y pasa al siguiente canal.
+    Se ejecuta en contexto de interrupción: si el anillo del canal está lleno, la muestra
+    sólo se guarda en adcLast y se cuenta en adcOverruns; si adcSkip no es 0, se descarta.
+    @param sample Resultado de la conversión (0 a 1023).
+    @return Pin del próximo canal a convertir.
+*/
+uint8_t adcStore(int sample) {
+    uint8_t channel = adcCurrent;
+    if (adcSkip) {
+        adcSkip--;
+    } else {
+        adcLast[channel] = sample;
+        if ((uint8_t)(adcHead[channel] - adcTail[channel]) < ADC_RING_SIZE) {
+            adcRing[channel][adcHead[channel] & (ADC_RING_SIZE - 1)] = sample;
+            adcHead[channel]++;
+        } else {
+            adcOverruns[channel]++;
+        }
+    }
+    adcCurrent = (channel + 1) % ADC_CHANNELS_QTY;
+    return adcChannels[adcCurrent];
+}
+
+#if defined(__AVR__)
+    /**
+        adcSchedule() programa el próximo Compare Match B un período después del anterior
+        o, si ese instante ya pasó (la interrupción se demoró más de un período), un período
+        después de ahora.
+    */
+    inline void adcSchedule() {
+        uint16_t next = OCR1B + ADC_TIMER1_STEP;
+        if ((int16_t)(next - TCNT1) <= 0) {
+            next = TCNT1 + ADC_TIMER1_STEP;
+        }
+        OCR1B = next;
+    }
+
+    /**
+        Interrupción de fin de conversión del ADC: guarda la muestra, selecciona el próximo canal
+        (la próxima conversión recién empieza con el siguiente Compare Match B), programa
+        ese Compare Match y baja el flag OCF1B para que vuelva a disparar al ADC.
+    */
+    ISR(ADC_vect) {
+        uint8_t next = adcStore(ADC);
+        ADMUX = _BV(REFS0) | ((next - A0) & 0x07);
+        adcSchedule();
+        TIFR1 = _BV(OCF1B);
+    }
+#elif defined(ARDUINO_NATIVE)
+    #include <NativeHardware.h>
+
+    /**
+        AdcEngineTicker reemplaza a Timer1 y a la interrupción del ADC en el host nativo:
+        cada 1/ADC_SAMPLE_RATE segundos del reloj virtual, convierte el canal actual (sin costo
+        para el programa) y llama a adcStore(), como lo haría ISR(ADC_vect).
+        Es un modelo de fondo (ver NativeTicker): cuando se saltea un intervalo (por ejemplo,
+        en power-down, con el ADC apagado), retoma su fase y convierte una vez cada canal,
+        para que adcLast no quede con una muestra vieja.
+    */
+    class AdcEngineTicker : public NativeTicker {
+    public:
+        AdcEngineTicker() : _next(NATIVE_NEVER) {}
+        void start() {
+            _next = nativeNanos() + 1000000000ULL / ADC_SAMPLE_RATE;
+        }
+        unsigned long long nextEvent() {
+            return _next;
+        }
+        void onEvent(unsigned long long now) {
+            (void)now;
+            _next += 1000000000ULL / ADC_SAMPLE_RATE;
+            if (nativeInterruptsEnabled()) {
+                adcStore(nativeAnalogSample(adcChannels[adcCurrent]));
+            }
+        }
+        bool background() {
+            return true;
+        }
+        void onSkip(unsigned long long now) {
+            const unsigned long long period = 1000000000ULL / ADC_SAMPLE_RATE;
+            if (_next == NATIVE_NEVER || _next > now) {
+                return;
+            }
+            _next += period * ((now - _next) / period + 1);
+            for (uint8_t i = 0; i < ADC_CHANNELS_QTY; i++) {
+                adcStore(nativeAnalogSample(adcChannels[adcCurrent]));
+            }
+        }
+    private:
+        unsigned long long _next;
+    };
+    AdcEngineTicker adcTicker;
+#endif
+
+/**
+    adcPause() detiene el motor, sin perder el canal actual, y espera a que termine la conversión
+    en curso, para que el programa principal pueda usar el ADC (ver adcVcc() y adcConvert()).
+*/
+void adcPause() {
+    #if defined(__AVR__)
+        ADCSRA &= ~(_BV(ADATE) | _BV(ADIE));
+        while (bit_is_set(ADCSRA, ADSC));
+    #endif
+}
+
+/**
+    adcResume() reanuda el motor detenido con adcPause(): vuelve a seleccionar el canal actual
+    y programa la próxima conversión un período después de ahora.
+*/
+void adcResume() {
+    #if defined(__AVR__)
+        ADMUX = _BV(REFS0) | ((adcChannels[adcCurrent] - A0) & 0x07);
+        OCR1B = TCNT1 + ADC_TIMER1_STEP;
+        TIFR1 = _BV(OCF1B);
+        ADCSRA |= _BV(ADIF) | _BV(ADATE) | _BV(ADIE);
+    #endif
+}
+
+/**
+    adcConvert() convierte un pin que el motor no muestrea (por ejemplo, la entrada de tensión
+    de EmonLib), con analogRead() y el motor en pausa: con el motor en marcha, analogRead()
+    competiría con la interrupción del ADC por ADMUX y por el resultado.
+    @param pin Pin analógico.
+    @return Valor de la entrada (0 a 1023).
+*/
+int adcConvert(uint8_t pin) {
+    adcPause();
+    int sample = analogRead(pin);
+    adcResume();
+    return sample;
+}
+
+/**
+    adcTake() saca la muestra más antigua del anillo de un canal.
+    Es el EmonSampleReader con el que EmonLib consume las muestras de corriente.
+    Un pin que el motor no muestrea se convierte en el momento (ver adcConvert()),
+    para que EmonLib no espere indefinidamente una muestra que nunca llegará.
+    @param pin Pin analógico del canal.
+    @param &sample Dirección de memoria donde se guarda la muestra.
+    @return true si había una muestra disponible (o si el motor no muestrea ese pin),
+    false si el anillo estaba vacío.
+*/
+boolean adcTake(unsigned int pin, int &sample) {
+    int channel = adcChannelOf(pin);
+    if (channel < 0) {
+        sample = adcConvert(pin);
+        return true;
+    }
+    if (adcHead[channel] == adcTail[channel]) {
+        return false;
+    }
+    sample = adcRing[channel][adcTail[channel] & (ADC_RING_SIZE - 1)];
+    adcTail[channel]++;
+    return true;
+}
+
+/**
+    adcFlush() descarta las muestras pendientes del anillo de un canal,
+    para que el próximo consumidor empiece por muestras contiguas y recientes.
+    @param pin Pin analógico del canal.
+*/
+void adcFlush(unsigned int pin) {
+    int channel = adcChannelOf(pin);
+    if (channel >= 0) {
+        adcTail[channel] = adcHead[channel];
+    }
+}
+
+/**
+    adcVcc() mide la tensión de alimentación (EnergyMonitor::readVcc()) con el motor en pausa,
+    ya que readVcc() reconfigura el ADC para convertir la referencia interna, y descarta
+    la primera conversión al reanudarlo.
+    Es el EmonVccReader de EmonLib, que sólo lo llama cada VCC_REFRESH_TIMEOUT segundos.
+    @return Tensión de alimentación (en mV).
+*/
+long adcVcc() {
+    adcPause();
+    long vcc = eMon.readVcc();
+    adcSkip = 1;
+    adcResume();
+    return vcc;
+}
+
+#endif
+
+/**
+    adcEngineBegin() configura Timer1 y el ADC para muestrear en ronda los canales de adcChannels
+    a ADC_SAMPLE_RATE conversiones por segundo, y hace que EmonLib tome sus muestras
+    de los anillos (ver adcTake() y adcVcc()).
+    Timer1 queda contando libremente, con la misma configuración que usa gpsUartBegin().
+    Con ADC_SAMPLING == ADC_SAMPLING_POLLED, no hace nada.
+*/
+void adcEngineBegin() {
+    #if ADC_SAMPLING == ADC_SAMPLING_ENGINE
+        adcCurrent = 0;
+        #if defined(__AVR__)
+            noInterrupts();
+            ADMUX = _BV(REFS0) | ((adcChannels[0] - A0) & 0x07);                 // Referencia AVcc, como analogRead().
+            ADCSRB = _BV(ADTS2) | _BV(ADTS0);                                    // Disparo: Timer1 Compare Match B.
+            ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADIE) | _BV(ADIF) |
+                _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);                            // Prescaler 128 (125 kHz).
+            TCCR1A = 0;
+            TCCR1B = _BV(CS11);                                                  // Modo normal, prescaler 8.
+            OCR1B = TCNT1 + ADC_TIMER1_STEP;
+            TIFR1 = _BV(OCF1B);
+            interrupts();
+        #elif defined(ARDUINO_NATIVE)
+            adcTicker.start();
+        #endif
+        eMon.sampleReader(adcTake, adcVcc);
+    #endif
+}
+
+/**
+    adcRead() obtiene el valor actual de una entrada analógica.
+    Con el motor en marcha, devuelve la última muestra del canal (y descarta las anteriores,
+    sin esperar ninguna conversión) o, si el motor no muestrea ese pin, lo convierte con el motor
+    en pausa (ver adcConvert()); en caso contrario, llama a analogRead().
+    @param pin Pin analógico.
+    @return Valor de la entrada (0 a 1023).
+*/
+int adcRead(uint8_t pin) {
+    #if ADC_SAMPLING == ADC_SAMPLING_ENGINE
+        int channel = adcChannelOf(pin);
+        if (channel >= 0) {
+            noInterrupts();
+            int sample = adcLast[channel];
+            interrupts();
+            adcFlush(pin);
+            return sample;
+        }
+        return adcConvert(pin);
+    #else
+        return analogRead(pin);
+    #endif
+}
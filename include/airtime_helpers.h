@@ -0,0 +1,121 @@
+/**
+    Header que contiene el modelo de tiempo en el aire (time-on-air) de los paquetes LoRa
+    y la verificación, en tiempo de compilación, del ciclo de trabajo de la banda.
+    El modelo es la fórmula de Semtech (SX1276/77/78/79 datasheet, sección 4.1.1.7):
+        Tsym     = 2^SF / BW
+        Tpreamb  = (preámbulo + 4.25) * Tsym
+        Npayload = 8 + max(ceil((8 * PL - 4 * SF + 28 + 16 * CRC - 20 * IH) / (4 * (SF - 2 * DE))) * CR, 0)
+        Tpacket  = Tpreamb + Npayload * Tsym
+    donde PL es el tamaño de la carga útil (en bytes), CR el denominador de la tasa de codificación,
+    IH vale 1 con encabezado implícito (este nodo siempre usa encabezado explícito) y DE vale 1
+    si el SX1278 tiene habilitada la optimización para tasas de datos bajas.
+    Las funciones son constexpr: se evalúan en tiempo de compilación en los static_assert
+    del final y también pueden llamarse en tiempo de ejecución (ver endLoRaPacket()).
+    @file airtime_helpers.h
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+/**
+    loRaSymbolTime() calcula la duración de un símbolo LoRa.
+    @param sf Factor de ensanchamiento.
+    @param bw Ancho de banda (en Hz).
+    @return Duración del símbolo (en us).
+*/
+constexpr double loRaSymbolTime(int sf, double bw) {
+    return (1L << sf) * 1E6 / bw;
+}
+
+/**
+    loRaLowDataRate() determina si la biblioteca LoRa habilita la optimización para tasas
+    de datos bajas (DE), replicando el cálculo entero de LoRaClass::setLdoFlag():
+    símbolos de más de 16 ms.
+    @param sf Factor de ensanchamiento.
+    @param bw Ancho de banda (en Hz).
+    @return 1 si DE está habilitado, 0 en caso contrario.
+*/
+constexpr int loRaLowDataRate(int sf, double bw) {
+    return 1000 / ((long)bw / (1L << sf)) > 16 ? 1 : 0;
+}
+
+/**
+    loRaPayloadSymbols() calcula la cantidad de símbolos que ocupan el encabezado
+    y la carga útil de un paquete LoRa con encabezado explícito.
+    @param length Tamaño de la carga útil (en bytes).
+    @param sf Factor de ensanchamiento.
+    @param bw Ancho de banda (en Hz).
+    @param cr Denominador de la tasa de codificación 4/cr.
+    @param crc true si el paquete lleva CRC.
+    @return Cantidad de símbolos.
+*/
+constexpr long loRaPayloadSymbols(long length, int sf, double bw, int cr, bool crc) {
+    return 8 + (8 * length - 4 * sf + 28 + 16 * crc <= 0 ? 0 :
+        (8 * length - 4 * sf + 28 + 16 * crc + 4 * (sf - 2 * loRaLowDataRate(sf, bw)) - 1) /
+        (4 * (sf - 2 * loRaLowDataRate(sf, bw))) * cr);
+}
+
+/**
+    loRaTimeOnAir() calcula el tiempo en el aire de un paquete LoRa.
+    @param length Tamaño de la carga útil (en bytes).
+    @param sf Factor de ensanchamiento.
+    @param bw Ancho de banda (en Hz).
+    @param cr Denominador de la tasa de codificación 4/cr.
+    @param preamble Longitud del preámbulo (en símbolos).
+    @param crc true si el paquete lleva CRC.
+    @return Tiempo en el aire (en us).
+*/
+constexpr double loRaTimeOnAir(long length, int sf, double bw, int cr, long preamble, bool crc) {
+    return (preamble + 4.25 + loRaPayloadSymbols(length, sf, bw, cr, crc)) * loRaSymbolTime(sf, bw);
+}
+
+/**
+    timeOnAir() calcula el tiempo en el aire de un paquete LoRa con la configuración
+    del módem de este nodo (LORA_SPREADING_FACTOR, LORA_BANDWIDTH, LORA_CODING_RATE,
+    LORA_PREAMBLE_LENGTH y LORA_CRC).
+    @param length Tamaño de la carga útil (en bytes).
+    @return Tiempo en el aire (en us).
+*/
+constexpr double timeOnAir(long length) {
+    return loRaTimeOnAir(length, LORA_SPREADING_FACTOR, LORA_BANDWIDTH, LORA_CODING_RATE,
+        LORA_PREAMBLE_LENGTH, LORA_CRC);
+}
+
+/**
+    worstCasePayloadSize() obtiene el tamaño máximo de la carga útil de un paquete
+    que agrupa una cantidad dada de ventanas, en el formato configurado (LORA_PAYLOAD_FORMAT y REPORT_CURRENT_STATS).
+    El payload ASCII simple se acota por MAX_SIZE_OUTCOMING_LORA_REPORT y el agrupado,
+    por el máximo que admite el SX1278 (LORA_MAX_PAYLOAD_SIZE).
+    @param windows Ventanas por paquete.
+    @return Tamaño de la carga útil (en bytes).
+*/
+constexpr long worstCasePayloadSize(int windows) {
+    #if LORA_PAYLOAD_FORMAT == PAYLOAD_FORMAT_BINARY && REPORT_CURRENT_STATS
+        return windows == 1 ? BINARY_PAYLOAD_STATS_SIZE : BINARY_BATCH_STATS_SIZE(windows);
+    #elif LORA_PAYLOAD_FORMAT == PAYLOAD_FORMAT_BINARY
+        return windows == 1 ? BINARY_PAYLOAD_SIZE : BINARY_BATCH_SIZE(windows);
+    #else
+        return windows == 1 ? MAX_SIZE_OUTCOMING_LORA_REPORT : LORA_MAX_PAYLOAD_SIZE;
+    #endif
+}
+
+/**
+    dutyCycleFits() verifica que, para todo agrupamiento desde una cantidad dada de ventanas
+    hasta LORA_BATCH_MAX, el paquete de peor caso no supere LORA_DUTY_CYCLE.
+    Con N ventanas por paquete se transmite, a lo sumo, un paquete cada N * LORA_TIMEOUT segundos
+    (el reporte por excepción sólo puede transmitir menos).
+    @param windows Primera cantidad de ventanas a verificar.
+    @return true si todos los agrupamientos respetan el ciclo de trabajo.
+*/
+constexpr bool dutyCycleFits(int windows) {
+    return windows > LORA_BATCH_MAX ||
+        (timeOnAir(worstCasePayloadSize(windows)) * 100 <= LORA_DUTY_CYCLE * windows * LORA_TIMEOUT * 1E6 &&
+        dutyCycleFits(windows + 1));
+}
+
+static_assert(MAX_SIZE_OUTCOMING_LORA_REPORT <= LORA_MAX_PAYLOAD_SIZE,
+    "MAX_SIZE_OUTCOMING_LORA_REPORT supera el máximo que admite el SX1278.");
+static_assert(worstCasePayloadSize(LORA_BATCH_MAX) <= LORA_MAX_PAYLOAD_SIZE,
+    "El paquete agrupado de LORA_BATCH_MAX ventanas supera el máximo que admite el SX1278.");
+static_assert(dutyCycleFits(1),
+    "El paquete de peor caso supera LORA_DUTY_CYCLE: aumentar LORA_TIMEOUT o reducir el payload, SF o BW.");
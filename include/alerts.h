@@ -3,13 +3,12 @@
     @file constants.h
     @author Franco Abosso
     @author Julio Donadello
-    @version 1.0 29/03/2021
+    @version 1.1 16/10/2026
 */
 
 int totalPitidos = 3;           // Total de pitidos por alarma.
 int tiempoPitido = 133;         // Tiempo de cada pitido del buzzer [ms].
-bool resetAlert = false;        // Flag responsable de resetear pitidosRestantes.
-int pitidosRestantes = 0;       // Variable que contiene los pitidos restantes.
+int pitidosRestantes = 0;       // Variable que contiene los pitidos restantes de la alerta en curso.
 
 /**
     blockingAlert() se encarga de realizar una subrutina bloqueante de alerta,
@@ -28,7 +27,9 @@ void blockingAlert(int tiempo, int pitidos) {
 
 /**
     startAlert() se encarga de inicializar la subrutina no bloqueante
-    de alerta, en base a una cantidad de tiempo y de pitidos dados como parámetros.
+    de alerta, en base a una cantidad de tiempo y de pitidos dados como parámetros,
+    dejando pendiente EVENT_ALERT (ver alertObserver()). Si ya había una alerta pedida que
+    todavía no empezó, la conserva; si hay una en curso, la nueva empieza al terminar aquélla.
     Por ejemplo:
         startAlert(133, 4);
     Realiza una serie de 4 pitidos en donde cada pitido (y no-pitido) del buzzer dura 133 ms.
@@ -36,11 +37,11 @@ void blockingAlert(int tiempo, int pitidos) {
     @param pitidos Cantidad de pitidos.
 */
 void startAlert(int tiempo, int pitidos) {
-    if (resetAlert && pitidosRestantes == 0) {
+    if (eventPending(events, EVENT_ALERT) && !eventPending(events, EVENT_BUZZER)) {
         return;
     } else {
         tiempoPitido = tiempo;
         totalPitidos = pitidos;
-        resetAlert = true;
+        eventPost(EVENT_ALERT);
     }
 }
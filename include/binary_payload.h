@@ -0,0 +1,319 @@
+/**
+    Header que define la carga útil binaria de LoRa (LORA_PAYLOAD_FORMAT == PAYLOAD_FORMAT_BINARY)
+    y las funciones para codificarla y decodificarla.
+    No depende de Arduino ni de constants.h: el concentrador LoRa (o cualquier programa en el host)
+    lo incluye tal cual para decodificar los paquetes del nodo.
+    Estructura (16 bytes, enteros en little-endian):
+        | Byte | Tamaño | Campo       | Codificación                                           |
+        | 0    | 2      | Dev ID      | uint16.                                                |
+        | 2    | 2      | Corriente   | uint16, en centiamperes (0xFFFF = sin mediciones).     |
+        | 4    | 1      | Flags       | bits 0-1: lluvia (0 = no, 1 = sí, 3 = sin votos),      |
+        |      |        |             | bit 2: posición GPS válida,                            |
+        |      |        |             | bits 5-7: versión del formato (BINARY_PAYLOAD_VERSION).|
+        | 5    | 1      | Combustible | uint8, fracción de CAPACIDAD_COMBUSTIBLE (255 = lleno).|
+        | 6    | 4      | Latitud     | int32, en 1e-5 grados.                                 |
+        | 10   | 4      | Longitud    | int32, en 1e-5 grados.                                 |
+        | 14   | 2      | Altitud     | int16, en metros.                                      |
+    El payload ASCII nunca mide 16 bytes, por lo que el concentrador distingue ambos
+    formatos por el tamaño del paquete.
+    Cuando el nodo agrupa varias ventanas en un único paquete (ver LORA_BATCH_MAX),
+    utiliza un encabezado compartido seguido de una entrada por ventana:
+        | Byte | Tamaño | Campo       | Codificación                                           |
+        | 0    | 2      | Dev ID      | uint16.                                                |
+        | 2    | 1      | Flags       | bit 2: posición GPS válida,                            |
+        |      |        |             | bits 5-7: versión del formato (BINARY_BATCH_VERSION).  |
+        | 3    | 1      | Ventanas    | uint8, cantidad de entradas (N).                       |
+        | 4    | 4      | Latitud     | int32, en 1e-5 grados (posición al momento del envío). |
+        | 8    | 4      | Longitud    | int32, en 1e-5 grados.                                 |
+        | 12   | 2      | Altitud     | int16, en metros.                                      |
+        | 14   | 6 * N  | Entradas    | de la más antigua a la más reciente:                   |
+        |      |        |  +0 (2)     | uint16, segundos transcurridos hasta el envío.         |
+        |      |        |  +2 (2)     | uint16, corriente (igual que en el payload simple).    |
+        |      |        |  +4 (1)     | bits 0-1: lluvia (igual que en el payload simple).     |
+        |      |        |  +5 (1)     | uint8, combustible (igual que en el payload simple).   |
+    Su tamaño (14 + 6 * N) nunca es 16, así que tampoco se confunde con el payload simple.
+    Si el nodo reporta las estadísticas de corriente (REPORT_CURRENT_STATS), ambos formatos
+    llevan 6 bytes más por ventana, en una versión propia:
+        | Byte | Tamaño | Campo       | Codificación                                           |
+        | +0   | 2      | Mínimo      | uint16, corriente mínima de la ventana (igual que      |
+        |      |        |             | Corriente, 0xFFFF = sin mediciones).                   |
+        | +2   | 2      | Máximo      | uint16, corriente máxima de la ventana.                |
+        | +4   | 2      | Desvío      | uint16, desvío estándar de la corriente de la ventana. |
+    El payload simple (versión BINARY_PAYLOAD_STATS_VERSION) los agrega a partir del byte 16
+    (22 bytes en total) y el agrupado (versión BINARY_BATCH_STATS_VERSION), a partir del byte 6
+    de cada entrada (14 + 12 * N bytes). Como 14 + 12 * N puede coincidir con 14 + 6 * M,
+    el concentrador distingue los payloads agrupados por su versión.
+    @file binary_payload.h
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.1 16/10/2026
+*/
+
+#ifndef BINARY_PAYLOAD_H
+#define BINARY_PAYLOAD_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define BINARY_PAYLOAD_SIZE 16          // Tamaño fijo del payload binario (en bytes).
+#define BINARY_PAYLOAD_VERSION 1        // Versión del formato, viaja en los bits 5-7 de Flags.
+#define BINARY_PAYLOAD_NO_CURRENT 0xFFFF // Corriente reservada para "sin mediciones".
+#define BINARY_PAYLOAD_FUEL_FULL 255    // Valor de combustible que representa al tanque lleno.
+#define BINARY_PAYLOAD_GPS_SCALE 100000L // Escala de latitud y longitud (1e-5 grados).
+
+#define BINARY_BATCH_VERSION 2          // Versión del formato agrupado, viaja en los bits 5-7 de Flags.
+#define BINARY_BATCH_HEADER_SIZE 14     // Tamaño del encabezado compartido (en bytes).
+#define BINARY_BATCH_WINDOW_SIZE 6      // Tamaño de cada entrada (en bytes).
+#define BINARY_BATCH_MAX_WINDOWS 40     // Máximo de entradas que entran en un paquete LoRa (255 bytes).
+#define BINARY_BATCH_SIZE(windows) (BINARY_BATCH_HEADER_SIZE + BINARY_BATCH_WINDOW_SIZE * (windows))
+
+#define BINARY_STATS_SIZE 6             // Mínimo, máximo y desvío estándar de la corriente (en bytes).
+#define BINARY_PAYLOAD_STATS_VERSION 3  // Versión del formato simple con estadísticas.
+#define BINARY_PAYLOAD_STATS_SIZE (BINARY_PAYLOAD_SIZE + BINARY_STATS_SIZE)
+#define BINARY_BATCH_STATS_VERSION 4    // Versión del formato agrupado con estadísticas.
+#define BINARY_BATCH_STATS_MAX_WINDOWS 20 // Máximo de entradas con estadísticas que entran en un paquete LoRa.
+#define BINARY_BATCH_STATS_SIZE(windows) (BINARY_BATCH_HEADER_SIZE + (BINARY_BATCH_WINDOW_SIZE + BINARY_STATS_SIZE) * (windows))
+
+/**
+    BinaryPayload contiene los campos del payload binario, ya escalados a enteros.
+*/
+struct BinaryPayload {
+    uint16_t deviceId;  // Identificador de nodo.
+    uint16_t current;   // Corriente promedio (en centiamperes), o BINARY_PAYLOAD_NO_CURRENT.
+    int8_t rain;        // Resultado de la votación de lluvia: 1, 0 ó -1 (sin votos).
+    uint8_t gas;        // Combustible como fracción de la capacidad (0 a BINARY_PAYLOAD_FUEL_FULL).
+    bool stats;         // true si el payload lleva currentMin, currentMax y currentStddev.
+    uint16_t currentMin;    // Corriente mínima (en centiamperes), o BINARY_PAYLOAD_NO_CURRENT.
+    uint16_t currentMax;    // Corriente máxima (en centiamperes), o BINARY_PAYLOAD_NO_CURRENT.
+    uint16_t currentStddev; // Desvío estándar de la corriente (en centiamperes), o BINARY_PAYLOAD_NO_CURRENT.
+    bool gpsValid;      // true si lat, lng y alt contienen una posición válida.
+    int32_t lat;        // Latitud (en 1e-5 grados).
+    int32_t lng;        // Longitud (en 1e-5 grados).
+    int16_t alt;        // Altitud (en metros).
+};
+
+/**
+    BinaryBatchWindow contiene los campos de una ventana dentro del payload agrupado.
+    El resto de los campos (Dev ID y posición) viajan una única vez, en el encabezado.
+*/
+struct BinaryBatchWindow {
+    uint16_t age;       // Segundos transcurridos entre el cierre de la ventana y el envío.
+    uint16_t current;   // Corriente promedio (en centiamperes), o BINARY_PAYLOAD_NO_CURRENT.
+    int8_t rain;        // Resultado de la votación de lluvia: 1, 0 ó -1 (sin votos).
+    uint8_t gas;        // Combustible como fracción de la capacidad (0 a BINARY_PAYLOAD_FUEL_FULL).
+    uint16_t currentMin;    // Sólo si el encabezado tiene stats (igual que en BinaryPayload).
+    uint16_t currentMax;
+    uint16_t currentStddev;
+};
+
+/**
+    encodeBinaryStats() serializa las estadísticas de corriente de una ventana.
+    @param min Corriente mínima (en centiamperes).
+    @param max Corriente máxima (en centiamperes).
+    @param stddev Desvío estándar de la corriente (en centiamperes).
+    @param buffer Destino, de al menos BINARY_STATS_SIZE bytes.
+*/
+inline void encodeBinaryStats(uint16_t min, uint16_t max, uint16_t stddev, uint8_t buffer[]) {
+    buffer[0] = min & 0xFF;
+    buffer[1] = min >> 8;
+    buffer[2] = max & 0xFF;
+    buffer[3] = max >> 8;
+    buffer[4] = stddev & 0xFF;
+    buffer[5] = stddev >> 8;
+}
+
+/**
+    decodeBinaryStats() deserializa las estadísticas de corriente de una ventana.
+    @param buffer Bytes recibidos (BINARY_STATS_SIZE).
+    @param &min Dirección de memoria de la corriente mínima.
+    @param &max Dirección de memoria de la corriente máxima.
+    @param &stddev Dirección de memoria del desvío estándar.
+*/
+inline void decodeBinaryStats(const uint8_t buffer[], uint16_t& min, uint16_t& max, uint16_t& stddev) {
+    min = buffer[0] | ((unsigned int)buffer[1] << 8);
+    max = buffer[2] | ((unsigned int)buffer[3] << 8);
+    stddev = buffer[4] | ((unsigned int)buffer[5] << 8);
+}
+
+/**
+    encodeBinaryPayload() serializa un BinaryPayload.
+    @param payload Campos a serializar.
+    @param buffer Destino, de al menos BINARY_PAYLOAD_SIZE bytes
+    (BINARY_PAYLOAD_STATS_SIZE si payload.stats es true).
+    @return Cantidad de bytes escritos (BINARY_PAYLOAD_SIZE o BINARY_PAYLOAD_STATS_SIZE).
+*/
+inline size_t encodeBinaryPayload(const BinaryPayload& payload, uint8_t buffer[]) {
+    uint8_t rainBits = payload.rain < 0 ? 3 : (payload.rain ? 1 : 0);
+    uint32_t lat = (uint32_t)payload.lat;
+    uint32_t lng = (uint32_t)payload.lng;
+    uint16_t alt = (uint16_t)payload.alt;
+
+    buffer[0] = payload.deviceId & 0xFF;
+    buffer[1] = payload.deviceId >> 8;
+    buffer[2] = payload.current & 0xFF;
+    buffer[3] = payload.current >> 8;
+    buffer[4] = rainBits | (payload.gpsValid ? 0x04 : 0x00) | ((payload.stats ? BINARY_PAYLOAD_STATS_VERSION : BINARY_PAYLOAD_VERSION) << 5);
+    buffer[5] = payload.gas;
+    for (int i = 0; i < 4; i++) {
+        buffer[6 + i] = (lat >> (8 * i)) & 0xFF;
+        buffer[10 + i] = (lng >> (8 * i)) & 0xFF;
+    }
+    buffer[14] = alt & 0xFF;
+    buffer[15] = alt >> 8;
+
+    if (payload.stats) {
+        encodeBinaryStats(payload.currentMin, payload.currentMax, payload.currentStddev, buffer + BINARY_PAYLOAD_SIZE);
+        return BINARY_PAYLOAD_STATS_SIZE;
+    }
+    return BINARY_PAYLOAD_SIZE;
+}
+
+/**
+    decodeBinaryPayload() deserializa un payload binario.
+    @param buffer Bytes recibidos.
+    @param size Cantidad de bytes recibidos.
+    @param &payload Dirección de memoria del BinaryPayload a completar.
+    @return true si el tamaño y la versión coinciden con los de este formato (con o sin estadísticas).
+*/
+inline bool decodeBinaryPayload(const uint8_t buffer[], size_t size, BinaryPayload& payload) {
+    if (size == BINARY_PAYLOAD_SIZE && (buffer[4] >> 5) == BINARY_PAYLOAD_VERSION) {
+        payload.stats = false;
+        payload.currentMin = BINARY_PAYLOAD_NO_CURRENT;
+        payload.currentMax = BINARY_PAYLOAD_NO_CURRENT;
+        payload.currentStddev = BINARY_PAYLOAD_NO_CURRENT;
+    } else if (size == BINARY_PAYLOAD_STATS_SIZE && (buffer[4] >> 5) == BINARY_PAYLOAD_STATS_VERSION) {
+        payload.stats = true;
+        decodeBinaryStats(buffer + BINARY_PAYLOAD_SIZE, payload.currentMin, payload.currentMax, payload.currentStddev);
+    } else {
+        return false;
+    }
+    uint32_t lat = 0;
+    uint32_t lng = 0;
+    for (int i = 0; i < 4; i++) {
+        lat |= (uint32_t)buffer[6 + i] << (8 * i);
+        lng |= (uint32_t)buffer[10 + i] << (8 * i);
+    }
+    uint8_t rainBits = buffer[4] & 0x03;
+
+    payload.deviceId = buffer[0] | ((unsigned int)buffer[1] << 8);
+    payload.current = buffer[2] | ((unsigned int)buffer[3] << 8);
+    payload.rain = rainBits == 1 ? 1 : (rainBits == 0 ? 0 : -1);
+    payload.gpsValid = (buffer[4] & 0x04) != 0;
+    payload.gas = buffer[5];
+    payload.lat = (int32_t)lat;
+    payload.lng = (int32_t)lng;
+    payload.alt = (int16_t)(buffer[14] | ((unsigned int)buffer[15] << 8));
+
+    return true;
+}
+
+/**
+    encodeBinaryBatch() serializa un payload agrupado.
+    @param header Dev ID, posición y stats (se ignoran current, rain, gas y las estadísticas).
+    @param windows Entradas a serializar, de la más antigua a la más reciente.
+    @param count Cantidad de entradas (hasta BINARY_BATCH_MAX_WINDOWS, o BINARY_BATCH_STATS_MAX_WINDOWS
+    si header.stats es true).
+    @param buffer Destino, de al menos BINARY_BATCH_SIZE(count) bytes
+    (BINARY_BATCH_STATS_SIZE(count) si header.stats es true).
+    @return Cantidad de bytes escritos (BINARY_BATCH_SIZE(count) o BINARY_BATCH_STATS_SIZE(count)).
+*/
+inline size_t encodeBinaryBatch(const BinaryPayload& header, const BinaryBatchWindow windows[], uint8_t count, uint8_t buffer[]) {
+    uint32_t lat = (uint32_t)header.lat;
+    uint32_t lng = (uint32_t)header.lng;
+    uint16_t alt = (uint16_t)header.alt;
+
+    buffer[0] = header.deviceId & 0xFF;
+    buffer[1] = header.deviceId >> 8;
+    buffer[2] = (header.gpsValid ? 0x04 : 0x00) | ((header.stats ? BINARY_BATCH_STATS_VERSION : BINARY_BATCH_VERSION) << 5);
+    buffer[3] = count;
+    for (int i = 0; i < 4; i++) {
+        buffer[4 + i] = (lat >> (8 * i)) & 0xFF;
+        buffer[8 + i] = (lng >> (8 * i)) & 0xFF;
+    }
+    buffer[12] = alt & 0xFF;
+    buffer[13] = alt >> 8;
+
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t *entry = buffer + (header.stats ? BINARY_BATCH_STATS_SIZE(i) : BINARY_BATCH_SIZE(i));
+        entry[0] = windows[i].age & 0xFF;
+        entry[1] = windows[i].age >> 8;
+        entry[2] = windows[i].current & 0xFF;
+        entry[3] = windows[i].current >> 8;
+        entry[4] = windows[i].rain < 0 ? 3 : (windows[i].rain ? 1 : 0);
+        entry[5] = windows[i].gas;
+        if (header.stats) {
+            encodeBinaryStats(windows[i].currentMin, windows[i].currentMax, windows[i].currentStddev,
+                entry + BINARY_BATCH_WINDOW_SIZE);
+        }
+    }
+
+    return header.stats ? BINARY_BATCH_STATS_SIZE(count) : BINARY_BATCH_SIZE(count);
+}
+
+/**
+    decodeBinaryBatch() deserializa un payload agrupado.
+    @param buffer Bytes recibidos.
+    @param size Cantidad de bytes recibidos.
+    @param &header Dirección de memoria del BinaryPayload a completar con Dev ID y posición.
+    @param windows Destino de las entradas, de al menos BINARY_BATCH_MAX_WINDOWS elementos.
+    @param &count Dirección de memoria de la cantidad de entradas.
+    @return true si el tamaño y la versión coinciden con los de este formato (con o sin estadísticas).
+*/
+inline bool decodeBinaryBatch(const uint8_t buffer[], size_t size, BinaryPayload& header, BinaryBatchWindow windows[], uint8_t& count) {
+    if (size < BINARY_BATCH_HEADER_SIZE) {
+        return false;
+    }
+    uint8_t version = buffer[2] >> 5;
+    if (version == BINARY_BATCH_VERSION) {
+        if (buffer[3] > BINARY_BATCH_MAX_WINDOWS || size != (size_t)BINARY_BATCH_SIZE(buffer[3])) {
+            return false;
+        }
+    } else if (version == BINARY_BATCH_STATS_VERSION) {
+        if (buffer[3] > BINARY_BATCH_STATS_MAX_WINDOWS || size != (size_t)BINARY_BATCH_STATS_SIZE(buffer[3])) {
+            return false;
+        }
+    } else {
+        return false;
+    }
+    uint32_t lat = 0;
+    uint32_t lng = 0;
+    for (int i = 0; i < 4; i++) {
+        lat |= (uint32_t)buffer[4 + i] << (8 * i);
+        lng |= (uint32_t)buffer[8 + i] << (8 * i);
+    }
+
+    header.deviceId = buffer[0] | ((unsigned int)buffer[1] << 8);
+    header.current = BINARY_PAYLOAD_NO_CURRENT;
+    header.rain = -1;
+    header.gas = 0;
+    header.stats = version == BINARY_BATCH_STATS_VERSION;
+    header.currentMin = BINARY_PAYLOAD_NO_CURRENT;
+    header.currentMax = BINARY_PAYLOAD_NO_CURRENT;
+    header.currentStddev = BINARY_PAYLOAD_NO_CURRENT;
+    header.gpsValid = (buffer[2] & 0x04) != 0;
+    header.lat = (int32_t)lat;
+    header.lng = (int32_t)lng;
+    header.alt = (int16_t)(buffer[12] | ((unsigned int)buffer[13] << 8));
+
+    count = buffer[3];
+    for (uint8_t i = 0; i < count; i++) {
+        const uint8_t *entry = buffer + (header.stats ? BINARY_BATCH_STATS_SIZE(i) : BINARY_BATCH_SIZE(i));
+        uint8_t rainBits = entry[4] & 0x03;
+        windows[i].age = entry[0] | ((unsigned int)entry[1] << 8);
+        windows[i].current = entry[2] | ((unsigned int)entry[3] << 8);
+        windows[i].rain = rainBits == 1 ? 1 : (rainBits == 0 ? 0 : -1);
+        windows[i].gas = entry[5];
+        if (header.stats) {
+            decodeBinaryStats(entry + BINARY_BATCH_WINDOW_SIZE,
+                windows[i].currentMin, windows[i].currentMax, windows[i].currentStddev);
+        } else {
+            windows[i].currentMin = BINARY_PAYLOAD_NO_CURRENT;
+            windows[i].currentMax = BINARY_PAYLOAD_NO_CURRENT;
+            windows[i].currentStddev = BINARY_PAYLOAD_NO_CURRENT;
+        }
+    }
+
+    return true;
+}
+
+#endif
@@ -3,7 +3,7 @@
     @file constants.h
     @author Franco Abosso
     @author Julio Donadello
-    @version 1.0 29/03/2021
+    @version 1.1 16/10/2026
 */
 
 /// Comunicación serial.
@@ -23,15 +23,104 @@
 #define INCOMING_PAYLOAD_MAX_SIZE 100                                               // Tamaño máximo esperado del payload LoRa entrante.
 #define INCOMING_FULL_MAX_SIZE (INCOMING_PAYLOAD_MAX_SIZE + DEVICE_ID_MAX_SIZE + 2) // Tamaño máximo esperado del mensaje entrante.
 #define MAX_SIZE_OUTCOMING_LORA_REPORT 200                                          // Tamaño máximo esperado del payload LoRa saliente.
-#define KNOWN_COMMANDS_SIZE 1                                                       // Cantidad de comandos LoRa conocidos.
+#define KNOWN_COMMANDS_SIZE 3                                                       // Cantidad de comandos LoRa conocidos.
 #define LORA_TIMEOUT 20                                                             // Tiempo entre cada mensaje LoRa.
 #define LORA_SYNC_WORD 0x34                                                         // Palabra de sincronización LoRa.
+#define LORA_TX_TIMEOUT 3000                                                        // Tiempo máximo de espera de la interrupción TxDone (en ms).
+
+// Configuración del módem LoRa (ver airtime_helpers.h).
+#define LORA_SPREADING_FACTOR 7     // Factor de ensanchamiento (7 a 12).
+#define LORA_BANDWIDTH 125E3        // Ancho de banda de la señal (en Hz).
+#define LORA_CODING_RATE 5          // Denominador de la tasa de codificación 4/x (5 a 8).
+#define LORA_PREAMBLE_LENGTH 8      // Longitud del preámbulo (en símbolos).
+#define LORA_CRC false              // Agrega el CRC de la carga útil a cada paquete.
+#define LORA_MAX_PAYLOAD_SIZE 255   // Tamaño máximo de la carga útil que admite el SX1278.
+#define LORA_DUTY_CYCLE 10          // Ciclo de trabajo máximo permitido en la banda (en %).
+#if LORA_SPREADING_FACTOR < 7 || LORA_SPREADING_FACTOR > 12
+    #error "LORA_SPREADING_FACTOR debe estar entre 7 y 12 (SF6 exige encabezado implícito)."
+#elif LORA_CODING_RATE < 5 || LORA_CODING_RATE > 8
+    #error "LORA_CODING_RATE debe estar entre 5 y 8."
+#endif
+
+// Estados de la transmisión LoRa asíncrona (ver LoRaTxObserver()).
+#define TX_IDLE 0 // El SX1278 está en modo recepción: se puede encolar un nuevo paquete.
+#define TX_BUSY 1 // El SX1278 está transmitiendo: se espera la interrupción TxDone.
+#define TX_DONE 2 // La interrupción TxDone llegó: falta volver a modo recepción.
+
+// Modos del SX1278 (ver radioReceive(), radioSleep() y radioTransmit()).
+#define RADIO_RX 0    // En recepción continua: DIO0 avisa la llegada de un paquete.
+#define RADIO_SLEEP 1 // Dormido: no recibe paquetes (LORA_RX_WINDOW ms luego de cada transmisión).
+#define RADIO_TX 2    // Transmitiendo (hasta que LoRaTxObserver() lo vuelve a poner en recepción).
+
+// Formatos de la carga útil LoRa saliente.
+#define PAYLOAD_FORMAT_ASCII 0                   // "<20009>current=0.65&raindrops=1&gas=6.21/12&..." (~80 bytes).
+#define PAYLOAD_FORMAT_BINARY 1                  // Estructura fija de 16 bytes (ver binary_payload.h).
+#define LORA_PAYLOAD_FORMAT PAYLOAD_FORMAT_ASCII // Formato utilizado por este nodo.
+#define REPORT_CURRENT_STATS false               // Agrega mínimo, máximo y desvío estándar de la corriente a cada ventana.
+
+// Modos de reporte LoRa (ver report_helpers.h).
+#define REPORT_MODE_PERIODIC 0                    // Se transmite un reporte cada LORA_TIMEOUT segundos.
+#define REPORT_MODE_EXCEPTION 1                   // Se transmite sólo si algún valor sale de su banda muerta.
+#ifndef LORA_REPORT_MODE                          // Se puede elegir al compilar (ver tools/node_sim/exception.sim).
+#define LORA_REPORT_MODE REPORT_MODE_PERIODIC     // Modo de reporte utilizado por este nodo.
+#endif
+#define DEADBAND_CURRENT 0.5                      // Banda muerta de corriente (en A).
+#define DEADBAND_GAS 0.5                          // Banda muerta de combustible (en L).
+#define DEADBAND_GPS 25                           // Banda muerta de posición (en m).
+#define HEARTBEAT_TIMEOUT 600                     // Tiempo máximo entre reportes, aun sin cambios (en s).
+
+// Agrupamiento de ventanas en un único paquete LoRa (ver report_helpers.h).
+#define LORA_BATCH_MAX 4                          // Ventanas que caben en el anillo (1 inhabilita el agrupamiento).
+#define LORA_BATCH_SIZE 1                         // Ventanas por paquete al iniciar (comando LoRa "batch=N").
+#if LORA_BATCH_MAX < 1 || LORA_BATCH_MAX > 40
+    #error "LORA_BATCH_MAX debe estar entre 1 y 40 (BINARY_BATCH_MAX_WINDOWS)."
+#elif LORA_PAYLOAD_FORMAT == PAYLOAD_FORMAT_ASCII && LORA_BATCH_MAX > 4
+    #error "El payload ASCII agrupado admite hasta 4 ventanas por paquete LoRa (255 bytes)."
+#elif LORA_PAYLOAD_FORMAT == PAYLOAD_FORMAT_ASCII && REPORT_CURRENT_STATS && LORA_BATCH_MAX > 2
+    #error "Con REPORT_CURRENT_STATS, el payload ASCII agrupado admite hasta 2 ventanas por paquete LoRa."
+#elif LORA_PAYLOAD_FORMAT == PAYLOAD_FORMAT_BINARY && REPORT_CURRENT_STATS && LORA_BATCH_MAX > 20
+    #error "Con REPORT_CURRENT_STATS, LORA_BATCH_MAX debe estar entre 1 y 20 (BINARY_BATCH_STATS_MAX_WINDOWS)."
+#endif
 
 /// Arrays.
 #define SENSORS_QTY 2          // Cantidad de sensores conectados.
 #define TIMEOUT_READ_SENSORS 2 // Tiempo entre mediciones.
-#define ARRAY_SIZE (LORA_TIMEOUT / TIMEOUT_READ_SENSORS + 3)
-#define TIMING_SLOTS 4 // Cantidad de slots necesarios de timing (ver timing_helpers.h)
+
+// Tareas periódicas (ver scheduler.h). El identificador de cada tarea es también su prioridad.
+#define TASK_REPORT 0          // Cierra la ventana de medición y transmite, cada LORA_TIMEOUT segundos.
+#define TASK_SENSORS 1         // Vuelve a pedir el refresco de los sensores, cada TIMEOUT_READ_SENSORS segundos.
+#define TASK_BUZZER 2          // Invierte el estado del buzzer, cada tiempoPitido ms (sólo durante una alerta).
+#define TASK_GPS 3             // Vuelve a pedir la posición, GPS_WAKE_LEAD ms antes de cada reporte (sólo con GPS_POWER_SAVE).
+#define TASK_PROFILE 4         // Vuelca el perfil de tiempos por puerto serial, cada PROFILER_DUMP_TIMEOUT segundos (sólo con PROFILER).
+#define SCHEDULER_TASKS 5      // Cantidad de tareas.
+
+// Eventos (ver events.h). El identificador de cada evento es también el orden en que se atiende.
+#define EVENT_CURRENT 0        // Se pidió medir la corriente (cada TIMEOUT_READ_SENSORS segundos).
+#define EVENT_RAIN 1           // Se pidió medir la lluvia (cada TIMEOUT_READ_SENSORS segundos).
+#define EVENT_GAS 2            // Se pidió medir el combustible (cada LORA_TIMEOUT segundos).
+#define EVENT_ALERT 3          // Se pidió iniciar una alerta (ver startAlert()).
+#define EVENT_BUZZER 4         // Hay una alerta en curso (sin manejador: lo baja toggleBuzzer()).
+#define EVENT_DOWNLINK 5       // Llegó un paquete LoRa (lo levanta la interrupción onReceive()).
+#define EVENT_COMMAND 6        // Hay un comando LoRa para ejecutar (en incomingPayload).
+#define EVENT_GPS 7            // Se pidió la posición del GPS.
+#define EVENTS_QTY 8           // Cantidad de eventos.
+
+// Perfilador de tiempos de ejecución (ver profiler.h).
+#define PROFILER false             // Mide el tiempo de ejecución de cada bloque de loop() (false no genera código).
+#define PROFILER_DUMP_TIMEOUT 60   // Tiempo entre volcados del perfil por puerto serial (en s).
+#define PROFILER_UPLINK true       // Responde al comando LoRa "prof" con un paquete de diagnóstico ("<20009>prof=...").
+#define PROFILER_BUCKETS 8         // Intervalos del histograma: menos de 16 us, de 64 us, ..., de 65 ms y el resto (0 no guarda histogramas).
+#define PROBE_LOOP 0               // Pasada completa de loop(), sin el tiempo dormido (ver powerIdle()).
+#define PROBE_REPORT 1             // Tarea TASK_REPORT (cierre de la ventana, composición y encolado del paquete).
+#define PROBE_CURRENT 2            // Medición de corriente (pollVI() y getNewCurrent()).
+#define PROBE_RAIN 3               // Medición de lluvia (getNewRaindrop()).
+#define PROBE_GAS 4                // Medición de combustible (pollGas() y getNewGas()).
+#define PROBE_LORA 5               // Observadores LoRa (TxDone y, al llegar un paquete, downlink y comandos, cada uno por separado).
+#define PROBE_GPS 6                // Lectura del GPS (getNewGPS()).
+#define PROFILER_PROBES 7          // Cantidad de sondas.
+#if PROFILER && PROFILER_UPLINK && LORA_PAYLOAD_FORMAT == PAYLOAD_FORMAT_BINARY
+    #error "El paquete de diagnóstico del perfilador es ASCII: PROFILER_UPLINK exige PAYLOAD_FORMAT_ASCII."
+#endif
 
 // Sensor de combustible.
 #define TIME_VACIO 1200          // Tiempo de retorno de eco ultrasónico cuando el tanque está vacío (en us).
@@ -39,6 +128,27 @@
 #define CAPACIDAD_COMBUSTIBLE 12 // Capacidad del tanque (en L).
 #define PING_SAMPLES 5           // Cantidad de muestras ultrasónicos.
 #define ULTRASONICO_DIST_MAX 300 // Distancia máxima medible por el ultrasónico (en cm).
+#define GAS_IDLE 0               // No hay una medición de combustible en curso (ver pollGas()).
+#define GAS_ECHO 1               // Se disparó un ping: la interrupción de Timer2 espera el eco.
+#define GAS_PAUSE 2              // Se espera PING_MEDIAN_DELAY desde el último ping para disparar el siguiente.
+
+// Muestreo del ADC (ver adc_engine.h).
+#define ADC_SAMPLING_POLLED 0                    // Cada medición llama a analogRead() y espera la conversión.
+#define ADC_SAMPLING_ENGINE 1                    // Timer1 dispara las conversiones y la interrupción del ADC las guarda.
+#define ADC_SAMPLING ADC_SAMPLING_ENGINE         // Modo de muestreo utilizado por este nodo.
+#define ADC_SAMPLE_RATE 4000                     // Conversiones por segundo, repartidas en ronda entre los canales.
+#define ADC_CHANNELS_QTY 2                       // Cantidad de canales muestreados (ver adcChannels en pinout.h).
+#define ADC_RING_SIZE 32                         // Muestras que guarda el anillo de cada canal (potencia de 2).
+#if ADC_SAMPLE_RATE < 250 || ADC_SAMPLE_RATE > 9000
+    #error "ADC_SAMPLE_RATE debe estar entre 250 y 9000 (una conversión dura 104 us)."
+#elif ADC_RING_SIZE < 2 || ADC_RING_SIZE > 128 || (ADC_RING_SIZE & (ADC_RING_SIZE - 1))
+    #error "ADC_RING_SIZE debe ser una potencia de 2 entre 2 y 128."
+#endif
+
+// Timer1, compartido por el motor del ADC y la recepción del GPS: modo normal (cuenta libremente
+// de 0 a 65535) con prescaler 8, es decir, 2 ticks por us a 16 MHz.
+#define TIMER1_TICKS_PER_SECOND (F_CPU / 8)
+#define ADC_TIMER1_STEP (TIMER1_TICKS_PER_SECOND / ADC_SAMPLE_RATE) // Ticks de Timer1 entre dos conversiones.
 
 // Sensor de corriente.
 #define TRANSFORMER_RATIO 100 / 0.05
@@ -48,16 +158,86 @@
 #define REAL_CURRENT 5.23
 #define EMON_CALIBRATION IDEAL_CALIBRATION * (REAL_CURRENT / MEASURED_CURRENT)
 #define THRESHOLD_NOISE_CURRENT 0.5
-#define EMON_CROSSINGS 20 // Cantidad de semi-ondas muestreadas para medir tensión y/o corriente.
-#define EMON_TIMEOUT 1000 // Timeout de la rutina calcVI (en ms).
+#define EMON_CROSSINGS 20       // Cantidad de semi-ondas muestreadas para medir tensión y/o corriente.
+#define EMON_TIMEOUT 1000       // Timeout de la rutina calcVI (en ms).
+#define VCC_REFRESH_TIMEOUT 60  // Tiempo entre mediciones de la tensión de alimentación (en s).
+#define REPORT_VCC false        // Agrega al payload ASCII la última tensión de alimentación medida (en mV, "&vcc=").
+#if REPORT_VCC && LORA_PAYLOAD_FORMAT == PAYLOAD_FORMAT_BINARY
+    #error "El payload binario no tiene campo de tensión: REPORT_VCC exige PAYLOAD_FORMAT_ASCII."
+#elif REPORT_VCC && LORA_BATCH_MAX > 3
+    #error "Con REPORT_VCC, el payload ASCII agrupado admite hasta 3 ventanas por paquete LoRa."
+#endif
+#if ADC_SAMPLING == ADC_SAMPLING_ENGINE
+    #define EMON_SAMPLES_PER_LOOP ADC_RING_SIZE // Muestras de corriente procesadas por cada pasada de loop() (ver pollVI()).
+#else
+    #define EMON_SAMPLES_PER_LOOP 4
+#endif
 
 // Sensor de lluvia.
 #define LLUVIA_THRESHOLD_VOLTAGE 2.5 // Tensión threshold cuando llueve.
 #define LLUVIA_THRESHOLD_10BIT ((int)(LLUVIA_THRESHOLD_VOLTAGE * (1024 / 5.0)))
+#define LLUVIA_HYSTERESIS_VOLTAGE 0.1 // Semiancho de la banda de histéresis alrededor del threshold (0 la inhabilita).
+#define LLUVIA_HYSTERESIS_10BIT ((int)(LLUVIA_HYSTERESIS_VOLTAGE * (1024 / 5.0)))
 #define LLUVIA_ACTIVO LOW
+static_assert(LLUVIA_HYSTERESIS_10BIT >= 0 && LLUVIA_THRESHOLD_10BIT - LLUVIA_HYSTERESIS_10BIT > 0 &&
+    LLUVIA_THRESHOLD_10BIT + LLUVIA_HYSTERESIS_10BIT < 1024,
+    "La banda de histéresis de lluvia debe quedar dentro del rango del ADC (0 a 1023).");
 
 // Sensor GPS.
 #define GPS_DECIMAL_POSITIONS 5 // Cantidad de posiciones decimales para medir la longitud y latitud del GPS.
+#define GPS_SENTENCE_FILTER true // Descartar las sentencias NMEA que no son GGA ni RMC apenas se conoce su tipo.
+#define GPS_CHUNK_SIZE 16       // Cantidad de caracteres recibidos del GPS que se le pasan juntos a GPS.encode().
+
+// Recepción del GPS (ver gps_uart.h).
+#define GPS_UART_SOFTWARE 0                     // SoftwareSerial: recibir cada byte deshabilita las interrupciones ~1 ms.
+#define GPS_UART_CAPTURE 1                      // Input capture de Timer1 (ICP1 = D8): el hardware registra cada flanco.
+#define GPS_UART GPS_UART_CAPTURE               // Modo de recepción utilizado por este nodo.
+#define GPS_WIRING_ORIGINAL 0                   // TX del GPS -> D9, RX del GPS <- D8 (cableado original de los nodos).
+#define GPS_WIRING_ICP1 1                       // TX del GPS -> D8 (ICP1), RX del GPS <- D9 (hay que cruzar D8 y D9 en el DB9).
+#define GPS_WIRING GPS_WIRING_ICP1              // Cableado de este nodo (ver pinout.h).
+#define GPS_RING_SIZE 64                        // Caracteres que guarda el anillo de recepción (potencia de 2).
+#define GPS_TICKS_PER_BIT ((TIMER1_TICKS_PER_SECOND + GPS_BPS / 2) / GPS_BPS) // Ticks de Timer1 por bit.
+#define GPS_STOP_TICKS (GPS_TICKS_PER_BIT * 37 / 4) // Desde el flanco del start bit hasta el stop bit (9,25 bits).
+#if GPS_UART == GPS_UART_CAPTURE && GPS_WIRING != GPS_WIRING_ICP1
+    #error "GPS_UART_CAPTURE exige GPS_WIRING_ICP1: el TX del GPS debe llegar a D8 (ICP1)."
+#elif GPS_UART == GPS_UART_CAPTURE && (GPS_BPS < 1200 || GPS_BPS > 38400)
+    #error "Con GPS_UART_CAPTURE, GPS_BPS debe estar entre 1200 y 38400."
+#elif GPS_RING_SIZE < 2 || GPS_RING_SIZE > 128 || (GPS_RING_SIZE & (GPS_RING_SIZE - 1))
+    #error "GPS_RING_SIZE debe ser una potencia de 2 entre 2 y 128."
+#endif
+
+// Ahorro de energía (ver power.h).
+#define POWER_SAVE_OFF 0                 // El MCU nunca duerme.
+#define POWER_SAVE_IDLE 1                // Al final de cada pasada de loop(), SLEEP_MODE_IDLE hasta la próxima interrupción.
+#define POWER_SAVE_DEEP 2                // Además, sin trabajo pendiente, power-down hasta la próxima tarea (despierta el watchdog).
+#define POWER_SAVE POWER_SAVE_IDLE       // Modo utilizado por este nodo.
+#define POWER_DOWN_MIN 16                // Tiempo mínimo hasta la próxima tarea para entrar en power-down (en ms).
+#define LORA_RX_WINDOW 0                 // Tiempo en recepción luego de cada transmisión, antes de dormir al SX1278 (en ms; 0 = siempre en recepción).
+#define GPS_POWER_SAVE false             // Pasar al GPS a modo backup (UBX-RXM-PMREQ por RX_GPS_PIN, ver GPS_WIRING) una vez obtenida la posición de cada ventana.
+#define GPS_WAKE_LEAD 5000               // Anticipación con que el GPS despierta antes de cada reporte (en ms).
+#define GPS_FIX_TIMEOUT 10000            // Tiempo máximo de espera de una posición antes de desistir hasta la próxima ventana (en ms).
+#define REPORT_ENERGY false              // Agrega al payload ASCII la energía estimada de la última ventana (en mJ, "&mj=").
+#if POWER_SAVE == POWER_SAVE_DEEP && LORA_RX_WINDOW == 0
+    #error "POWER_SAVE_DEEP exige LORA_RX_WINDOW > 0 (en power-down, DIO0 no despierta al MCU)."
+#elif GPS_POWER_SAVE && GPS_UART == GPS_UART_CAPTURE && GPS_WIRING != GPS_WIRING_ICP1
+    #error "GPS_POWER_SAVE con GPS_UART_CAPTURE transmite por D9, que sólo va al RX del GPS con GPS_WIRING_ICP1."
+#elif GPS_POWER_SAVE && GPS_WAKE_LEAD >= LORA_TIMEOUT * 1000
+    #error "GPS_WAKE_LEAD debe ser menor que LORA_TIMEOUT."
+#elif REPORT_ENERGY && LORA_PAYLOAD_FORMAT == PAYLOAD_FORMAT_BINARY
+    #error "El payload binario no tiene campo de energía: REPORT_ENERGY exige PAYLOAD_FORMAT_ASCII."
+#endif
+
+// Consumos típicos para la estimación de energía (en uA, ver powerCloseCycle()).
+#define POWER_SUPPLY_VOLTAGE 5.0         // Tensión de alimentación (en V).
+#define POWER_UA_MCU_ACTIVE 9000         // ATmega328P activo a 16 MHz y 5 V.
+#define POWER_UA_MCU_IDLE 3000           // ATmega328P en SLEEP_MODE_IDLE (Timer0, Timer1 y ADC activos).
+#define POWER_UA_MCU_DOWN 10             // ATmega328P en power-down con el watchdog.
+#define POWER_UA_LORA_TX 120000          // SX1278 transmitiendo a +20 dBm.
+#define POWER_UA_LORA_RX 11000           // SX1278 en recepción continua.
+#define POWER_UA_LORA_SLEEP 1            // SX1278 en modo sleep.
+#define POWER_UA_GPS_ON 45000            // NEO-6M adquiriendo o siguiendo satélites.
+#define POWER_UA_GPS_BACKUP 20           // NEO-6M en modo backup.
+#define POWER_UA_BOARD 5000              // Regulador, LED de encendido y resto de la placa.
 
 // Actuador buzzer.
 #define BUZZER_ACTIVO HIGH
@@ -0,0 +1,152 @@
+/**
+    Header que contiene un despachador de eventos: cada evento es un bit de una única máscara
+    (pending) que levantan las interrupciones, las tareas del planificador o los propios manejadores,
+    y tiene asociada una función (su manejador) en una tabla. eventsRun() ejecuta, en orden
+    de identificador, sólo los manejadores de los eventos pendientes, en lugar de consultar
+    un flag distinto por cada trabajo en cada pasada de loop(); y eventsIdle() indica, con
+    una única lectura, que no hay nada pendiente.
+    Los eventos son por nivel: un evento queda pendiente (y su manejador se ejecuta en cada
+    pasada) hasta que alguien lo baja con eventReset(), por lo general el propio manejador una vez
+    terminado el trabajo, que puede llevar varias pasadas (por ejemplo, una medición de corriente).
+    La máscara es de 8 bits, por lo que el AVR la lee en una única instrucción; eventSet()
+    y eventReset() la leen y la escriben, por lo que fuera de una interrupción deben llamarse
+    con las interrupciones deshabilitadas (ver eventPost() y eventClear() en timing_helpers.h).
+    Al igual que scheduler.h, no depende de Arduino.
+    @file events.h
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include <stdint.h>
+
+#ifndef EVENTS_QTY
+#define EVENTS_QTY 8      // Cantidad de eventos (identificadores 0 a EVENTS_QTY - 1).
+#endif
+#define EVENTS_ALL 0xFF   // Máscara con todos los eventos habilitados (ver eventsRun()).
+
+#if EVENTS_QTY > 8
+    #error "La máscara de eventos es de 8 bits: EVENTS_QTY debe ser 8 o menos."
+#endif
+
+/**
+    EventHandler es la función que atiende un evento pendiente.
+*/
+typedef void (*EventHandler)();
+
+/**
+    EventDispatcher contiene la máscara de eventos pendientes y la tabla de manejadores.
+    Un evento sin manejador (0) sólo indica un estado: cuenta como pendiente para eventsIdle().
+*/
+struct EventDispatcher {
+    volatile uint8_t pending;           // Bit id en 1 mientras el evento id esté pendiente.
+    EventHandler handlers[EVENTS_QTY];  // Manejador de cada evento.
+};
+
+/**
+    eventBit() obtiene la máscara de un evento.
+    @param id Identificador del evento.
+    @return Máscara con sólo el bit del evento en 1.
+*/
+inline uint8_t eventBit(uint8_t id) {
+    return (uint8_t)(1 << id);
+}
+
+/**
+    eventsReset() vacía un despachador: sin eventos pendientes ni manejadores.
+    @param &dispatcher Dirección de memoria del despachador.
+*/
+inline void eventsReset(EventDispatcher& dispatcher) {
+    dispatcher.pending = 0;
+    for (uint8_t id = 0; id < EVENTS_QTY; id++) {
+        dispatcher.handlers[id] = 0;
+    }
+}
+
+/**
+    eventHandle() asigna el manejador de un evento. Por ejemplo:
+        eventHandle(dispatcher, 0, blink);
+    Ejecuta blink() en cada eventsRun() mientras el evento 0 esté pendiente.
+    @param &dispatcher Dirección de memoria del despachador.
+    @param id Identificador del evento (0 a EVENTS_QTY - 1).
+    @param handler Manejador, o 0 para un evento que sólo indica un estado.
+*/
+inline void eventHandle(EventDispatcher& dispatcher, uint8_t id, EventHandler handler) {
+    dispatcher.handlers[id] = handler;
+}
+
+/**
+    eventSet() deja pendiente un evento. Fuera de una interrupción, debe llamarse con las
+    interrupciones deshabilitadas.
+    @param &dispatcher Dirección de memoria del despachador.
+    @param id Identificador del evento.
+*/
+inline void eventSet(EventDispatcher& dispatcher, uint8_t id) {
+    dispatcher.pending |= eventBit(id);
+}
+
+/**
+    eventReset() deja de tener pendiente un evento. Fuera de una interrupción, debe llamarse
+    con las interrupciones deshabilitadas.
+    @param &dispatcher Dirección de memoria del despachador.
+    @param id Identificador del evento.
+*/
+inline void eventReset(EventDispatcher& dispatcher, uint8_t id) {
+    dispatcher.pending &= ~eventBit(id);
+}
+
+/**
+    eventPending() determina si un evento está pendiente.
+    @param dispatcher Despachador.
+    @param id Identificador del evento.
+    @return true si el evento está pendiente.
+*/
+inline bool eventPending(const EventDispatcher& dispatcher, uint8_t id) {
+    return (dispatcher.pending & eventBit(id)) != 0;
+}
+
+/**
+    eventsAny() determina si alguno de los eventos de una máscara está pendiente.
+    @param dispatcher Despachador.
+    @param mask Máscara de eventos (ver eventBit()).
+    @return true si alguno está pendiente.
+*/
+inline bool eventsAny(const EventDispatcher& dispatcher, uint8_t mask) {
+    return (dispatcher.pending & mask) != 0;
+}
+
+/**
+    eventsIdle() determina si no hay ningún evento pendiente.
+    @param dispatcher Despachador.
+    @return true si no hay eventos pendientes.
+*/
+inline bool eventsIdle(const EventDispatcher& dispatcher) {
+    return dispatcher.pending == 0;
+}
+
+/**
+    eventsRun() ejecuta, en orden de identificador, los manejadores de los eventos pendientes
+    que estén habilitados en enabled. Cada evento se consulta justo antes de ejecutar su
+    manejador, por lo que un manejador puede dejar pendiente un evento de identificador mayor
+    para que se atienda en la misma llamada (y uno de identificador menor, en la siguiente).
+    @param &dispatcher Dirección de memoria del despachador.
+    @param enabled Máscara de eventos habilitados (EVENTS_ALL para todos); los demás
+    quedan pendientes para una llamada posterior.
+    Termina apenas no quedan eventos habilitados pendientes de identificador mayor.
+    @return Cantidad de manejadores ejecutados.
+*/
+inline uint8_t eventsRun(EventDispatcher& dispatcher, uint8_t enabled) {
+    uint8_t executed = 0;
+    for (uint8_t id = 0; id < EVENTS_QTY && ((dispatcher.pending & enabled) >> id) != 0; id++) {
+        if ((dispatcher.pending & enabled & eventBit(id)) && dispatcher.handlers[id]) {
+            dispatcher.handlers[id]();
+            executed++;
+        }
+    }
+    return executed;
+}
+
+#endif
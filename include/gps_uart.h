@@ -0,0 +1,204 @@
+/**
+    Header que contiene la recepción de los caracteres del GPS.
+    Con GPS_UART == GPS_UART_CAPTURE, la unidad de input capture de Timer1 registra en hardware
+    el instante de cada flanco de la línea (TX_GPS_PIN = D8 = ICP1, ver GPS_WIRING) y su interrupción reconstruye los bits
+    a partir de la distancia entre flancos, como AltSoftSerial; Compare Match A marca el fin de
+    un carácter cuyos últimos bits no tienen flancos. Así, las interrupciones nunca se deshabilitan
+    durante la recepción (SoftwareSerial lo hace ~1 ms por carácter, demorando a DIO0 del SX1278,
+    a millis() y al motor del ADC) y los caracteres se guardan en gpsRing aunque loop() esté ocupado.
+    Timer1 cuenta libremente (ver TIMER1_TICKS_PER_SECOND), compartido con el motor del ADC,
+    que sólo usa Compare Match B. La transmisión (sólo para los pocos comandos UBX que el nodo le
+    envía al GPS, ver gpsBackup()) se hace por RX_GPS_PIN, midiendo cada bit con Timer1.
+    Con GPS_UART == GPS_UART_SOFTWARE, se recibe y transmite con SoftwareSerial (ssGPS).
+    @file gps_uart.h
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.1 16/10/2026
+*/
+
+#if GPS_UART == GPS_UART_CAPTURE
+
+/**
+    gpsStore() guarda un carácter recién recibido en gpsRing.
+    Se ejecuta en contexto de interrupción: si el anillo está lleno, el carácter se descarta
+    y se cuenta en gpsOverruns.
+    @param c Carácter recibido.
+*/
+void gpsStore(uint8_t c) {
+    if ((uint8_t)(gpsHead - gpsTail) < GPS_RING_SIZE) {
+        gpsRing[gpsHead & (GPS_RING_SIZE - 1)] = c;
+        gpsHead++;
+    } else {
+        gpsOverruns++;
+    }
+}
+
+#if defined(__AVR__)
+    /**
+        gpsCaptureEdge() selecciona el flanco que registra la unidad de input capture
+        (el datasheet pide bajar ICF1 luego de cambiarlo).
+        @param rising true para el flanco ascendente, false para el descendente.
+    */
+    inline void gpsCaptureEdge(bool rising) {
+        if (rising) {
+            TCCR1B |= _BV(ICES1);
+        } else {
+            TCCR1B &= ~_BV(ICES1);
+        }
+        TIFR1 = _BV(ICF1);
+    }
+
+    /**
+        gpsFinish() guarda el carácter en recepción y vuelve a esperar un start bit.
+    */
+    inline void gpsFinish() {
+        TIMSK1 &= ~_BV(OCIE1A);
+        gpsStore(gpsRxByte);
+        gpsRxBit = 0;
+        gpsRxLevel = 0x80;
+        gpsCaptureEdge(false);
+    }
+
+    /**
+        Interrupción de input capture: un flanco en ICP1.
+        Si se esperaba un start bit, el flanco descendente marca el inicio del carácter: el centro
+        del primer bit de datos está 1,5 bits después, y el stop bit 9,25 bits después (Compare
+        Match A). Si no, todos los bits cuyo centro quedó antes del flanco tenían el nivel anterior.
+    */
+    ISR(TIMER1_CAPT_vect) {
+        uint16_t capture = ICR1;
+        if (gpsRxBit == 0) {
+            OCR1A = capture + GPS_STOP_TICKS;
+            TIFR1 = _BV(OCF1A);
+            TIMSK1 |= _BV(OCIE1A);
+            gpsRxTarget = capture + GPS_TICKS_PER_BIT + GPS_TICKS_PER_BIT / 2;
+            gpsRxBit = 1;
+            gpsRxByte = 0;
+            gpsRxLevel = 0;
+            gpsCaptureEdge(true);
+            return;
+        }
+        while ((int16_t)(capture - gpsRxTarget) >= 0) {
+            gpsRxByte = (gpsRxByte >> 1) | gpsRxLevel;
+            gpsRxTarget += GPS_TICKS_PER_BIT;
+            if (++gpsRxBit > 8) {
+                gpsFinish();
+                return;
+            }
+        }
+        gpsRxLevel ^= 0x80;
+        gpsCaptureEdge(gpsRxLevel == 0);
+    }
+
+    /**
+        Interrupción de Compare Match A: llegó el stop bit sin que los últimos bits de datos
+        tuvieran flancos, por lo que todos tienen el nivel actual de la línea.
+    */
+    ISR(TIMER1_COMPA_vect) {
+        while (gpsRxBit <= 8) {
+            gpsRxByte = (gpsRxByte >> 1) | gpsRxLevel;
+            gpsRxBit++;
+        }
+        gpsFinish();
+    }
+#elif defined(ARDUINO_NATIVE)
+    #include <NativeUart.h>
+#endif
+
+#endif
+
+/**
+    gpsUartBegin() configura la recepción del GPS a GPS_BPS.
+    Con GPS_UART == GPS_UART_CAPTURE, pone a Timer1 a contar libremente (la misma configuración
+    que usa adcEngineBegin(), por lo que no importa cuál se llame primero) y habilita
+    la interrupción de input capture en el flanco descendente. Con GPS_POWER_SAVE, RX_GPS_PIN
+    queda en alto (reposo); si no, el nodo nunca le transmite al GPS y el pin queda como entrada,
+    así que un nodo con el cableado original (TX del GPS en D9, ver GPS_WIRING) no tiene dos
+    salidas enfrentadas.
+*/
+void gpsUartBegin() {
+    #if GPS_UART == GPS_UART_CAPTURE
+        #if defined(__AVR__)
+            pinMode(TX_GPS_PIN, INPUT_PULLUP);
+            #if GPS_POWER_SAVE
+                digitalWrite(RX_GPS_PIN, HIGH);                                  // Línea en reposo.
+                pinMode(RX_GPS_PIN, OUTPUT);
+            #endif
+            noInterrupts();
+            TCCR1A = 0;
+            TCCR1B = _BV(CS11);                                                  // Modo normal, prescaler 8, flanco descendente.
+            TIFR1 = _BV(ICF1);
+            TIMSK1 |= _BV(ICIE1);
+            interrupts();
+        #elif defined(ARDUINO_NATIVE)
+            GPSWire.begin(GPS_BPS, gpsStore);
+        #endif
+    #else
+        ssGPS.begin(GPS_BPS);
+    #endif
+}
+
+/**
+    gpsUartRead() saca caracteres recibidos del GPS, sin esperar ninguno.
+    @param buffer Array donde se guardan los caracteres.
+    @param size Cantidad máxima de caracteres a sacar.
+    @return Cantidad de caracteres guardados en buffer (0 si no había ninguno).
+*/
+size_t gpsUartRead(char buffer[], size_t size) {
+    size_t length = 0;
+    #if GPS_UART == GPS_UART_CAPTURE
+        while (length < size && gpsTail != gpsHead) {
+            buffer[length++] = gpsRing[gpsTail & (GPS_RING_SIZE - 1)];
+            gpsTail++;
+        }
+    #else
+        while (length < size && ssGPS.available() > 0) {
+            buffer[length++] = ssGPS.read();
+        }
+    #endif
+    return length;
+}
+
+/**
+    gpsUartWrite() le transmite caracteres al GPS a GPS_BPS, esperando a que salgan todos.
+    Con GPS_UART == GPS_UART_CAPTURE, cada flanco se programa GPS_TICKS_PER_BIT ticks de Timer1
+    después del anterior (contando desde el start bit, por lo que los errores no se acumulan)
+    y se espera con las interrupciones habilitadas: sólo se deshabilitan para escribir el pin,
+    así que DIO0, millis(), el motor del ADC y la recepción del GPS siguen atendiéndose.
+    Una interrupción que coincide con un flanco lo demora lo que dure (unos pocos µs, frente
+    a la tolerancia de medio bit, ~52 µs a 9600 bps, del receptor). Timer1 no tiene un tercer
+    Compare Match para transmitir por interrupción como AltSoftSerial (A marca el stop bit
+    de la recepción y B, las conversiones del ADC), por lo que la espera es activa (~1 ms por
+    carácter a 9600 bps) y sólo debe usarse para comandos cortos y esporádicos.
+    @param data Caracteres a transmitir.
+    @param length Cantidad de caracteres.
+*/
+void gpsUartWrite(const uint8_t data[], size_t length) {
+    #if GPS_UART == GPS_UART_CAPTURE
+        #if defined(__AVR__)
+            volatile uint8_t *port = portOutputRegister(digitalPinToPort(RX_GPS_PIN));
+            uint8_t mask = digitalPinToBitMask(RX_GPS_PIN);
+            for (size_t i = 0; i < length; i++) {
+                uint16_t frame = ((uint16_t)data[i] << 1) | 0x200;                // Start bit, 8 bits de datos y stop bit.
+                uint16_t edge = TCNT1;
+                for (uint8_t bit = 0; bit < 10; bit++) {
+                    noInterrupts();                                              // *port es compartido con otros pines.
+                    if (frame & 1) {
+                        *port |= mask;
+                    } else {
+                        *port &= ~mask;
+                    }
+                    interrupts();
+                    frame >>= 1;
+                    edge += GPS_TICKS_PER_BIT;
+                    while ((int16_t)(TCNT1 - edge) < 0);
+                }
+            }
+        #elif defined(ARDUINO_NATIVE)
+            (void)data;
+            nativeAdvance(length * 10000000000ULL / GPS_BPS);
+        #endif
+    #else
+        ssGPS.write(data, length);
+    #endif
+}
@@ -3,7 +3,7 @@
     @file pinout.h
     @author Franco Abosso
     @author Julio Donadello
-    @version 1.6 29/03/2021
+    @version 1.7 16/10/2026
 */
 
 /*
@@ -46,7 +46,9 @@
         - Puerto RS232 (1):
             - Sensor de corriente = A1.
             - Sensor de lluvia = A0.
-            - Sensor GPS = D8 (RX) + D9 (TX).
+            - Sensor GPS = D8 (RX) + D9 (TX), con el cableado original (GPS_WIRING_ORIGINAL).
+              Con GPS_WIRING_ICP1 (exigido por GPS_UART_CAPTURE, ya que sólo D8 es ICP1), D8 y D9
+              se cruzan en el DB9: D8 (TX) + D9 (RX).
             - Actuador buzzer (y LED) = D7.
 */
 
@@ -54,8 +56,13 @@
 #define CORRIENTE_PIN A1
 #define LLUVIA_PIN A0
 #define BUZZER_PIN 7
-#define RX_GPS_PIN 8
-#define TX_GPS_PIN 9
+#if GPS_WIRING == GPS_WIRING_ICP1
+    #define RX_GPS_PIN 9            // Pin conectado al RX del GPS.
+    #define TX_GPS_PIN 8            // Pin conectado al TX del GPS (ICP1).
+#else
+    #define RX_GPS_PIN 8
+    #define TX_GPS_PIN 9
+#endif
 #define COMBUSTIBLE_ECHO_PIN 6      // A través de cable SparkOn.
 #define COMBUSTIBLE_TRIG_PIN 5      // A través de cable SparkOn.
 
@@ -63,11 +70,19 @@
 // Instanciamiento de objetos relacionados al pinout.
 EnergyMonitor eMon;
 NewPing sonar(COMBUSTIBLE_TRIG_PIN, COMBUSTIBLE_ECHO_PIN, ULTRASONICO_DIST_MAX);
-SoftwareSerial ssGPS(TX_GPS_PIN, RX_GPS_PIN); // hacemos cruce de señales por SW, respecto del método constructor (TX -> RX, RX -> TX)
+#if GPS_UART == GPS_UART_SOFTWARE
+    SoftwareSerial ssGPS(TX_GPS_PIN, RX_GPS_PIN); // hacemos cruce de señales por SW, respecto del método constructor (TX -> RX, RX -> TX)
+#elif TX_GPS_PIN != 8
+    #error "Con GPS_UART_CAPTURE, el GPS debe transmitir al pin D8 (ICP1)."
+#endif
 TinyGPSPlus GPS;
 
+// Canales que muestrea en ronda el motor del ADC (ver adc_engine.h).
+const uint8_t adcChannels[ADC_CHANNELS_QTY] = {CORRIENTE_PIN, LLUVIA_PIN};
+
 /**
-    setupPinout() determina las I/Os digitales y calibra el módulo sensor de corriente.
+    setupPinout() determina las I/Os digitales y calibra el módulo sensor de corriente
+    (incluido cada cuánto vuelve a medir la tensión de alimentación, ver VCC_REFRESH_TIMEOUT).
 */
 void setupPinout() {
     #ifdef BUZZER_PIN
@@ -81,5 +96,6 @@ void setupPinout() {
     #endif
     #ifdef CORRIENTE_PIN
         eMon.current(CORRIENTE_PIN, EMON_CALIBRATION); 
+        eMon.vccRefreshInterval(VCC_REFRESH_TIMEOUT * 1000UL);
     #endif
 }
@@ -0,0 +1,353 @@
+/**
+    Header que contiene el manejo de energía del nodo:
+        - powerBegin() apaga los periféricos del MCU que el programa no usa,
+        - powerIdle(), al final de cada pasada de loop(), duerme al MCU: con POWER_SAVE_IDLE,
+          en SLEEP_MODE_IDLE hasta la próxima interrupción (a lo sumo ~1 ms, el desborde de Timer0),
+          ya que todo el trabajo pendiente lo generan interrupciones o el paso del tiempo;
+          con POWER_SAVE_DEEP, además, si no hay nada pendiente (ver powerBusy()),
+          en power-down hasta la próxima tarea del planificador, despertado por el watchdog,
+        - radioReceive(), radioTransmit() y radioSleep() siguen el modo del SX1278: con
+          LORA_RX_WINDOW > 0, powerObserver() lo duerme una vez pasada la ventana de recepción
+          de cada transmisión,
+        - con GPS_POWER_SAVE, powerObserver() pasa al GPS a modo backup (ver gpsBackup()) apenas
+          obtiene la posición de la ventana, hasta GPS_WAKE_LEAD ms antes del próximo reporte,
+        - powerCloseCycle() estima la energía consumida en cada ventana de LORA_TIMEOUT segundos,
+          a partir del tiempo que cada componente pasó en cada estado y de sus consumos típicos
+          (POWER_UA_MCU_ACTIVE y siguientes).
+    @file power.h
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+#if defined(__AVR__) && POWER_SAVE == POWER_SAVE_DEEP
+    // Milisegundos que cuenta el core de Arduino (wiring.c); en power-down, Timer0 no avanza.
+    extern volatile unsigned long timer0_millis;
+
+    /**
+        Interrupción del watchdog en modo interrupción: sólo despierta al MCU (ver powerDown()).
+    */
+    ISR(WDT_vect) {
+    }
+#endif
+
+/**
+    watchdogBegin() habilita el watchdog timer en WATCHDOG_TMR segundos (si USE_WATCHDOG_TMR).
+*/
+void watchdogBegin() {
+    #if USE_WATCHDOG_TMR == TRUE
+        #if WATCHDOG_TMR >= 8
+            wdt_enable(WDTO_8S);
+        #elif WATCHDOG_TMR >= 4
+            wdt_enable(WDTO_4S);
+        #elif WATCHDOG_TMR >= 2
+            wdt_enable(WDTO_2S);
+        #else
+            wdt_enable(WDTO_1S);
+        #endif
+    #endif
+}
+
+/**
+    powerBegin() apaga los periféricos del MCU que el programa no usa:
+        - el comparador analógico y los buffers digitales de las entradas analógicas,
+        - TWI (I2C) y, sin puerto serial (DEBUG_LEVEL == 0), USART0,
+        - Timer2 si el combustible es falso (GAS_MOCK; si no, lo usa NewPing)
+          y Timer1 si no lo usan ni el motor del ADC ni la recepción del GPS.
+    Además, abre la primera ventana de la estimación de energía (ver powerCloseCycle()),
+    que cuenta desde ahora y no desde millis() == 0.
+    Debe llamarse al final de setup(), una vez que nada más escribe por el puerto serial.
+*/
+void powerBegin() {
+    #if defined(__AVR__)
+        ACSR = _BV(ACD);
+        DIDR0 = _BV(CORRIENTE_PIN - A0) | _BV(LLUVIA_PIN - A0);
+        power_twi_disable();
+        #if DEBUG_LEVEL == 0
+            power_usart0_disable();
+        #endif
+        #ifdef GAS_MOCK
+            power_timer2_disable();
+        #endif
+        #if ADC_SAMPLING != ADC_SAMPLING_ENGINE && GPS_UART != GPS_UART_CAPTURE
+            power_timer1_disable();
+        #endif
+    #endif
+
+    powerCycleMillis = millis();
+    powerRxMillis = 0;
+}
+
+/**
+    radioReceive() pone al SX1278 en recepción continua y abre la ventana de recepción
+    (ver LORA_RX_WINDOW y powerObserver()).
+*/
+void radioReceive() {
+    uint32_t now = millis();
+    if (radioMode == RADIO_RX) {
+        powerRxMillis += now - radioMillis;
+    }
+    LoRa.receive();
+    radioMode = RADIO_RX;
+    radioMillis = now;
+}
+
+/**
+    radioTransmit() registra que el SX1278 deja de recibir para transmitir un paquete
+    (su tiempo en el aire se contabiliza en LoRaTotalAirtime).
+*/
+void radioTransmit() {
+    uint32_t now = millis();
+    if (radioMode == RADIO_RX) {
+        powerRxMillis += now - radioMillis;
+    }
+    radioMode = RADIO_TX;
+    radioMillis = now;
+}
+
+/**
+    radioSleep() duerme al SX1278: deja de recibir paquetes hasta la próxima transmisión.
+*/
+void radioSleep() {
+    uint32_t now = millis();
+    if (radioMode == RADIO_RX) {
+        powerRxMillis += now - radioMillis;
+    }
+    LoRa.sleep();
+    radioMode = RADIO_SLEEP;
+    radioMillis = now;
+}
+
+/**
+    gpsBackup() le pide al GPS (u-blox NEO-6M) que pase a modo backup durante duration ms,
+    con el comando UBX-RXM-PMREQ; al vencer, el GPS se despierta solo (arranque en caliente).
+    El comando sale por RX_GPS_PIN, el pin cableado al RX del GPS según GPS_WIRING
+    (D8 con el cableado original, D9 con GPS_WIRING_ICP1).
+    @param duration Tiempo en modo backup (en ms).
+*/
+void gpsBackup(unsigned long duration) {
+    // Sincronismo, clase y mensaje (RXM-PMREQ), largo (8), duración, flags (backup) y checksum.
+    uint8_t command[16] = {0xB5, 0x62, 0x02, 0x41, 0x08, 0x00,
+        (uint8_t)duration, (uint8_t)(duration >> 8), (uint8_t)(duration >> 16), (uint8_t)(duration >> 24),
+        0x02, 0x00, 0x00, 0x00, 0x00, 0x00};
+    for (uint8_t i = 2; i < 14; i++) {
+        command[14] += command[i];
+        command[15] += command[14];
+    }
+    gpsUartWrite(command, sizeof(command));
+
+    uint32_t now = millis();
+    gpsBackupMillis += duration;
+    gpsBackupUntil = now + duration;
+    gpsAsleep = true;
+    #if DEBUG_LEVEL >= 2
+        Serial.print("GPS en backup por ");
+        Serial.print(duration);
+        Serial.println(" ms");
+    #endif
+}
+
+/**
+    gpsWakeTask() es la tarea TASK_GPS (sólo con GPS_POWER_SAVE): GPS_WAKE_LEAD ms antes de cada
+    reporte, el GPS sale del modo backup y se vuelve a pedir la posición.
+*/
+void gpsWakeTask() {
+    gpsAsleep = false;
+    eventPost(EVENT_GPS);
+    GPSRequestFixes = GPS.sentencesWithFix();
+    GPSRequestMillis = millis();
+}
+
+/**
+    powerObserver() se encarga de:
+        - dormir al SX1278 una vez cerrada la ventana de recepción (LORA_RX_WINDOW ms desde
+          la última transmisión), salvo que haya un paquete entrante sin procesar,
+        - con GPS_POWER_SAVE, una vez obtenida (o abandonada luego de GPS_FIX_TIMEOUT ms, ver
+          gpsFixObserver()) la posición de la ventana, pasar al GPS a modo backup hasta el próximo TASK_GPS.
+*/
+void powerObserver() {
+    #if LORA_RX_WINDOW > 0
+        if (radioMode == RADIO_RX && LoRaTxState == TX_IDLE && !eventPending(events, EVENT_DOWNLINK) &&
+            millis() - radioMillis >= LORA_RX_WINDOW) {
+            radioSleep();
+        }
+    #endif
+
+    #if GPS_POWER_SAVE
+        if (!eventPending(events, EVENT_GPS) && !gpsAsleep && taskActive(scheduler, TASK_GPS)) {
+            // Si falta menos de un segundo para despertarlo, no vale la pena dormirlo.
+            int32_t wake = (int32_t)(scheduler.tasks[TASK_GPS].due - millis());
+            if (wake >= (int32_t)sec2ms(1)) {
+                gpsBackup(wake);
+            }
+        }
+    #endif
+}
+
+/**
+    powerBusy() determina si hay algún trabajo pendiente que no pueda esperar a la próxima tarea
+    del planificador, es decir, si el MCU no puede entrar en power-down.
+    @return true si hay eventos pendientes (mediciones, alertas, mensajes o un pedido de posición,
+    ver events.h), si hay una transmisión en curso, si el SX1278 está en recepción
+    o si quedan caracteres del GPS por procesar.
+*/
+bool powerBusy() {
+    return !eventsIdle(events) || LoRaTxState != TX_IDLE || radioMode == RADIO_RX
+        #if GPS_UART == GPS_UART_CAPTURE
+            || gpsHead != gpsTail
+        #endif
+        ;
+}
+
+#if POWER_SAVE == POWER_SAVE_DEEP
+    /**
+        powerDown() duerme al MCU en power-down durante (aproximadamente) duration ms, en tramos
+        de 16 ms a 8 s que mide el watchdog en modo interrupción; luego de cada tramo, suma su
+        duración a millis(). El oscilador del watchdog tiene una tolerancia de ~10 %, que se
+        traslada a la duración real de los tramos. Durante el power-down, el ADC se apaga
+        (Timer1 y Timer0 se detienen) y luego se restablecen el ADC y el watchdog timer.
+        @param duration Tiempo a dormir (en ms, al menos POWER_DOWN_MIN).
+    */
+    void powerDown(unsigned long duration) {
+        #if DEBUG_LEVEL >= 1
+            Serial.flush();
+        #endif
+        #if defined(__AVR__)
+            uint8_t adcsra = ADCSRA;
+            ADCSRA = adcsra & ~_BV(ADEN);
+        #endif
+        while (duration >= POWER_DOWN_MIN) {
+            // Tramo más largo que no supere a duration: 16 ms * 2^prescaler (prescaler 0 a 9).
+            uint8_t prescaler = 9;
+            while ((16UL << prescaler) > duration) {
+                prescaler--;
+            }
+            unsigned long slept = 16UL << prescaler;
+            #if defined(__AVR__)
+                uint8_t wdtcsr = _BV(WDIE) | ((prescaler & 0x08) ? _BV(WDP3) : 0) | (prescaler & 0x07);
+                noInterrupts();
+                wdt_reset();
+                MCUSR &= ~_BV(WDRF);
+                // Secuencia temporizada: WDTCSR se escribe a lo sumo 4 ciclos después de WDCE,
+                // por lo que ambos valores se cargan antes en registros (como wdt_enable()).
+                __asm__ __volatile__ (
+                    "sts %0, %1" "\n\t"
+                    "sts %0, %2" "\n\t"
+                    :
+                    : "n" (_SFR_MEM_ADDR(WDTCSR)), "r" ((uint8_t)(_BV(WDCE) | _BV(WDE))), "r" (wdtcsr)
+                    : "memory"
+                );
+                set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+                sleep_enable();
+                sleep_bod_disable();
+                interrupts();
+                sleep_cpu();
+                sleep_disable();
+                noInterrupts();
+                timer0_millis += slept;
+                interrupts();
+            #elif defined(ARDUINO_NATIVE)
+                wdt_disable();
+                nativeSkipTo(nativeNanos() + slept * 1000000ULL);                // Sin el ADC (ver NativeTicker).
+            #endif
+            powerDownMillis += slept;
+            duration -= slept;
+        }
+        #if defined(__AVR__)
+            wdt_disable();
+            ADCSRA = adcsra | _BV(ADIF);
+        #endif
+        watchdogBegin();
+    }
+#endif
+
+/**
+    powerIdle() duerme al MCU hasta que haya algo que hacer (ver el encabezado de este archivo)
+    y acumula el tiempo dormido para la estimación de energía.
+    Si una interrupción levanta un flag justo antes de dormir, se atiende en la próxima
+    interrupción (a lo sumo ~1 ms después, con Timer0).
+*/
+void powerIdle() {
+    #if POWER_SAVE == POWER_SAVE_DEEP
+        if (!powerBusy()) {
+            uint32_t remaining = schedulerIdle(scheduler, millis());
+            if (remaining >= POWER_DOWN_MIN) {
+                powerDown(remaining);
+                return;
+            }
+        }
+    #endif
+    #if POWER_SAVE != POWER_SAVE_OFF
+        uint32_t start = micros();
+        #if defined(__AVR__)
+            set_sleep_mode(SLEEP_MODE_IDLE);
+            sleep_mode();
+        #elif defined(ARDUINO_NATIVE)
+            // El próximo desborde de Timer0 (cada 1024 us) despierta al MCU, si no lo hizo antes otra interrupción.
+            nativeSleep(1024000ULL - nativeNanos() % 1024000ULL);
+        #endif
+        powerIdleMicros += micros() - start;
+    #endif
+}
+
+/**
+    powerCloseCycle() cierra la estimación de energía de la ventana actual y abre la siguiente.
+    La energía es la suma, para cada componente, del tiempo que pasó en cada estado por su
+    consumo típico, por POWER_SUPPLY_VOLTAGE:
+        - MCU: dormido en SLEEP_MODE_IDLE o en power-down (medido) y activo el resto del tiempo,
+        - SX1278: transmitiendo (LoRaTotalAirtime), en recepción (medido) y dormido el resto,
+        - GPS: en modo backup (pedido con gpsBackup()) y encendido el resto,
+        - POWER_UA_BOARD durante toda la ventana.
+    Es una estimación: no incluye los sensores ni el buzzer, y los consumos reales dependen
+    de cada módulo y de la tensión de alimentación.
+    @return Energía estimada de la ventana (en mJ), que también queda en powerLastCycle.
+*/
+float powerCloseCycle() {
+    uint32_t now = millis();
+    unsigned long elapsed = now - powerCycleMillis;
+
+    if (radioMode == RADIO_RX) {
+        powerRxMillis += now - radioMillis;
+        radioMillis = now;
+    }
+    unsigned long tx = min(LoRaTotalAirtime - powerCycleAirtime, elapsed);
+    unsigned long rx = min(powerRxMillis, elapsed - tx);
+
+    unsigned long idle = powerIdleMicros / 1000;
+    unsigned long asleep = min(idle + powerDownMillis, elapsed);
+
+    // El modo backup que sigue después de ahora corresponde a la próxima ventana.
+    unsigned long backupCarry = (int32_t)(gpsBackupUntil - now) > 0 ? gpsBackupUntil - now : 0;
+    unsigned long backup = min(gpsBackupMillis - min(backupCarry, gpsBackupMillis), elapsed);
+
+    float charge = (float)(elapsed - asleep) * POWER_UA_MCU_ACTIVE +             // En uA * ms.
+        (float)min(idle, asleep) * POWER_UA_MCU_IDLE +
+        (float)(asleep - min(idle, asleep)) * POWER_UA_MCU_DOWN +
+        (float)tx * POWER_UA_LORA_TX + (float)rx * POWER_UA_LORA_RX +
+        (float)(elapsed - tx - rx) * POWER_UA_LORA_SLEEP +
+        (float)(elapsed - backup) * POWER_UA_GPS_ON + (float)backup * POWER_UA_GPS_BACKUP +
+        (float)elapsed * POWER_UA_BOARD;
+    powerLastCycle = charge * POWER_SUPPLY_VOLTAGE / 1E6;
+
+    #if DEBUG_LEVEL >= 2
+        Serial.print("Energía de la ventana: ");
+        Serial.print(powerLastCycle);
+        Serial.print(" mJ (");
+        Serial.print(elapsed > 0 ? charge / elapsed / 1000 : 0.0);
+        Serial.print(" mA promedio; MCU dormido ");
+        Serial.print(asleep);
+        Serial.print(" ms, SX1278 en recepción ");
+        Serial.print(rx);
+        Serial.print(" ms, GPS en backup ");
+        Serial.print(backup);
+        Serial.println(" ms)");
+    #endif
+
+    powerCycleMillis = now;
+    powerCycleAirtime = LoRaTotalAirtime;
+    powerIdleMicros = 0;
+    powerDownMillis = 0;
+    powerRxMillis = 0;
+    gpsBackupMillis = backupCarry;
+    return powerLastCycle;
+}
@@ -0,0 +1,106 @@
+/**
+    Header que contiene el acumulador del perfilador de tiempos de ejecución (ver PROFILER):
+    cada sonda (ProfileProbe) acumula, durante un período, la cantidad de ejecuciones medidas,
+    el tiempo total y el máximo, además del peor tiempo desde el arranque y un histograma
+    logarítmico: el intervalo b cuenta las ejecuciones de menos de 16 * 4^b us (el último,
+    todas las demás). Los intervalos son contadores de 8 bits que se saturan en 255: los
+    intervalos lentos, que son los que interesan, cuentan exactamente sus pocas ejecuciones,
+    y los rápidos sólo indican "255 o más" (la cantidad total la da count).
+    Con 8 intervalos, cada sonda ocupa 20 bytes (140 con las 7 sondas de main.cpp); con
+    PROFILER_BUCKETS 0 no se guardan histogramas y ocupa 12 (84). count y total son de 32 bits
+    porque una pasada de loop() sin POWER_SAVE se repite cientos de miles de veces por período.
+    Al igual que scheduler.h, no depende de Arduino: los tiempos (en us) son parámetros.
+    La medición (PROFILE()) y los volcados están en timing_helpers.h y LoRa_helpers.h.
+    @file profiler.h
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+
+#ifndef PROFILER_BUCKETS
+#define PROFILER_BUCKETS 8 // Intervalos del histograma.
+#endif
+
+/**
+    ProfileProbe contiene el estado de una sonda.
+    max y worst se saturan en 65535 us (65 ms o más).
+*/
+struct ProfileProbe {
+    uint32_t count;                       // Ejecuciones medidas en el período.
+    uint32_t total;                       // Tiempo total del período (en us).
+    uint16_t max;                         // Tiempo máximo del período (en us).
+    uint16_t worst;                       // Tiempo máximo desde el arranque (en us).
+    #if PROFILER_BUCKETS > 0
+        uint8_t histogram[PROFILER_BUCKETS];  // Ejecuciones del período por intervalo (255 o más).
+    #endif
+};
+
+#if PROFILER_BUCKETS > 0
+/**
+    profileBucket() obtiene el intervalo del histograma que corresponde a un tiempo.
+    @param us Tiempo (en us).
+    @return Intervalo (0 a PROFILER_BUCKETS - 1): 0 para menos de 16 us, 1 para menos de 64 us, etc.
+*/
+inline uint8_t profileBucket(uint32_t us) {
+    uint8_t bucket = 0;
+    for (us >>= 4; us > 0 && bucket < PROFILER_BUCKETS - 1; us >>= 2) {
+        bucket++;
+    }
+    return bucket;
+}
+#endif
+
+/**
+    profileRecord() agrega una ejecución a una sonda.
+    @param &probe Dirección de memoria de la sonda.
+    @param us Tiempo de la ejecución (en us).
+*/
+inline void profileRecord(ProfileProbe& probe, uint32_t us) {
+    uint16_t saturated = us < 0xFFFF ? (uint16_t)us : 0xFFFF;
+    probe.count++;
+    probe.total += us;
+    if (saturated > probe.max) {
+        probe.max = saturated;
+    }
+    if (saturated > probe.worst) {
+        probe.worst = saturated;
+    }
+
+    #if PROFILER_BUCKETS > 0
+        uint8_t bucket = profileBucket(us);
+        if (probe.histogram[bucket] < 0xFF) {
+            probe.histogram[bucket]++;
+        }
+    #endif
+}
+
+/**
+    profileReset() vacía el período de una sonda (conserva el peor tiempo desde el arranque).
+    @param &probe Dirección de memoria de la sonda.
+*/
+inline void profileReset(ProfileProbe& probe) {
+    probe.count = 0;
+    probe.total = 0;
+    probe.max = 0;
+    #if PROFILER_BUCKETS > 0
+        for (uint8_t b = 0; b < PROFILER_BUCKETS; b++) {
+            probe.histogram[b] = 0;
+        }
+    #endif
+}
+
+/**
+    profileMean() obtiene el tiempo medio del período de una sonda.
+    @param probe Sonda.
+    @return Tiempo medio (en us), o 0 si no hubo ejecuciones.
+*/
+inline uint32_t profileMean(const ProfileProbe& probe) {
+    return probe.count > 0 ? probe.total / probe.count : 0;
+}
+
+#endif
@@ -0,0 +1,286 @@
+/**
+    Header que contiene funcionalidades referidas al contenido de cada reporte LoRa,
+    a la decisión de transmitirlo (reporte por excepción) y al anillo de ventanas
+    que se agrupan en un único paquete (ver LORA_BATCH_MAX).
+    @file report_helpers.h
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+/**
+    reportedCurrent() obtiene la corriente a reportar: la media de las mediciones
+    de la ventana, redondeada a 2 decimales (NaN si no hubo mediciones).
+    @param stats Estadísticas de corriente de la ventana.
+    @return Corriente a reportar (en A).
+*/
+float reportedCurrent(const RunningStats& stats) {
+    #if DEBUG_LEVEL >= 5
+        Serial.print("Corriente: n = ");
+        Serial.print(stats.count);
+        Serial.print(", media = ");
+        Serial.print(statsMean(stats));
+        Serial.print(", min = ");
+        Serial.print(statsMin(stats));
+        Serial.print(", max = ");
+        Serial.print(statsMax(stats));
+        Serial.print(", desvío = ");
+        Serial.println(statsStddev(stats));
+    #endif
+    if (!stats.count) {
+        return NAN;
+    }
+    return round2decimals(statsMean(stats));
+}
+
+/**
+    binaryCurrent() convierte una corriente al formato del payload binario.
+    @param current Corriente (en A), o NaN si no hubo mediciones.
+    @return Corriente en centiamperes, o BINARY_PAYLOAD_NO_CURRENT.
+*/
+uint16_t binaryCurrent(float current) {
+    if (isnan(current)) {
+        return BINARY_PAYLOAD_NO_CURRENT;
+    }
+    return (uint16_t)constrain(current * 100 + 0.5, 0, BINARY_PAYLOAD_NO_CURRENT - 1);
+}
+
+/**
+    reduceCurrent() reduce las estadísticas de corriente de una ventana a los valores que se
+    reportan y se guardan en el anillo de ventanas (ver WindowCurrent): la media (ver
+    reportedCurrent()) y, sólo con REPORT_CURRENT_STATS, el mínimo, el máximo y el desvío estándar.
+    @param stats Estadísticas de corriente de la ventana.
+    @return Corriente de la ventana.
+*/
+WindowCurrent reduceCurrent(const RunningStats& stats) {
+    WindowCurrent current;
+    current.mean = reportedCurrent(stats);
+    #if REPORT_CURRENT_STATS
+        current.min = binaryCurrent(statsMin(stats));
+        current.max = binaryCurrent(statsMax(stats));
+        current.stddev = binaryCurrent(statsStddev(stats));
+    #endif
+    return current;
+}
+
+/**
+    reportedRaindrop() obtiene el resultado de la votación de lluvia a reportar
+    (o RAINDROP_MOCK, si está definido).
+    @param votes Votos de lluvia de la ventana.
+    @return 1, 0 ó -1 (sin votos).
+*/
+int reportedRaindrop(const VoteCounter& votes) {
+    #ifndef RAINDROP_MOCK
+        return votesResult(votes);
+    #else
+        return RAINDROP_MOCK;
+    #endif
+}
+
+/**
+    reportedGas() obtiene la cantidad de combustible a reportar, redondeada a 2 decimales
+    (o GAS_MOCK, si está definido).
+    @param gas Número con coma flotante con la medición de combustible.
+    @return Combustible a reportar (en L).
+*/
+float reportedGas(float gas) {
+    #ifndef GAS_MOCK
+        return round2decimals(gas);
+    #else
+        return round2decimals(GAS_MOCK);
+    #endif
+}
+
+/**
+    reportedPosition() obtiene la posición a reportar, del GPS (o de GPS_MOCK, si está definido).
+    @param &lat Dirección de memoria de la latitud (en grados).
+    @param &lng Dirección de memoria de la longitud (en grados).
+    @param &alt Dirección de memoria de la altitud (en metros).
+    @return true si la posición es válida. En caso contrario, lat, lng y alt no se modifican.
+*/
+bool reportedPosition(double& lat, double& lng, double& alt) {
+    #ifndef GPS_MOCK
+        if (!GPS.location.isValid()) {
+            return false;
+        }
+        lat = GPS.location.lat();
+        lng = GPS.location.lng();
+        alt = GPS.altitude.meters();
+    #else
+        lat = GPS_MOCK[0];
+        lng = GPS_MOCK[1];
+        alt = GPS_MOCK[2];
+    #endif
+    return true;
+}
+
+/**
+    outOfDeadband() determina si un valor salió de la banda muerta centrada en el último valor reportado.
+    Un valor NaN (sin mediciones) sólo se considera distinto de otro que no lo sea.
+    @param value Valor actual.
+    @param last Último valor reportado.
+    @param deadband Semiancho de la banda muerta.
+    @return true si |value - last| >= deadband.
+*/
+bool outOfDeadband(float value, float last, float deadband) {
+    if (isnan(value) || isnan(last)) {
+        return isnan(value) != isnan(last);
+    }
+    return fabs(value - last) >= deadband;
+}
+
+/**
+    isReportDue() decide si corresponde reportar la ventana actual.
+    Con LORA_REPORT_MODE == REPORT_MODE_PERIODIC, siempre devuelve true.
+    Con LORA_REPORT_MODE == REPORT_MODE_EXCEPTION, devuelve true si:
+        - todavía no se reportó ninguna ventana,
+        - pasaron HEARTBEAT_TIMEOUT segundos desde que salió al aire el último reporte
+          (ver rememberReportSent()),
+        - la corriente salió de su banda muerta (DEADBAND_CURRENT),
+        - cambió el resultado de la votación de lluvia (ignorando las abstenciones),
+        - el combustible salió de su banda muerta (DEADBAND_GAS),
+        - la posición se movió DEADBAND_GPS metros o más, o cambió su validez.
+    @param current Corriente de la ventana (ver reportedCurrent()).
+    @param raindrop Resultado de la votación de lluvia de la ventana (ver reportedRaindrop()).
+    @param gas Combustible de la ventana (ver reportedGas()).
+    @return true si la ventana debe reportarse.
+*/
+bool isReportDue(float current, int raindrop, float gas) {
+    #if LORA_REPORT_MODE == REPORT_MODE_EXCEPTION
+        if (!lastReportValid || millis() - lastReportMillis >= sec2ms(HEARTBEAT_TIMEOUT)) {
+            return true;
+        }
+
+        double lat = 0.0;
+        double lng = 0.0;
+        double alt = 0.0;
+        bool GPSValid = reportedPosition(lat, lng, alt);
+
+        bool currentChanged = outOfDeadband(current, lastReportCurrent, DEADBAND_CURRENT);
+        bool raindropChanged = raindrop != -1 && raindrop != lastReportRaindrop;
+        bool gasChanged = outOfDeadband(gas, lastReportGas, DEADBAND_GAS);
+        bool GPSChanged = GPSValid != lastReportGPSValid ||
+            (GPSValid && TinyGPSPlus::distanceBetween(lat, lng, lastReportLat, lastReportLng) >= DEADBAND_GPS);
+
+        #if DEBUG_LEVEL >= 2
+            if (currentChanged) Serial.println("Excepción: corriente");
+            if (raindropChanged) Serial.println("Excepción: lluvia");
+            if (gasChanged) Serial.println("Excepción: combustible");
+            if (GPSChanged) Serial.println("Excepción: posición");
+        #endif
+
+        return currentChanged || raindropChanged || gasChanged || GPSChanged;
+    #else
+        (void)current;
+        (void)raindrop;
+        (void)gas;
+        return true;
+    #endif
+}
+
+/**
+    rememberReport() almacena los valores de la ventana recién reportada,
+    para que isReportDue() los compare con los siguientes.
+    @param current Corriente de la ventana.
+    @param raindrop Resultado de la votación de lluvia de la ventana.
+    @param gas Combustible de la ventana.
+*/
+void rememberReport(float current, int raindrop, float gas) {
+    #if LORA_REPORT_MODE == REPORT_MODE_EXCEPTION
+        double alt = 0.0;
+
+        lastReportCurrent = current;
+        if (raindrop != -1) {
+            lastReportRaindrop = raindrop;
+        }
+        lastReportGas = gas;
+        lastReportGPSValid = reportedPosition(lastReportLat, lastReportLng, alt);
+        lastReportValid = true;
+    #else
+        (void)current;
+        (void)raindrop;
+        (void)gas;
+    #endif
+}
+
+/**
+    rememberReportSent() almacena el cierre de ventana en que salió al aire el último paquete
+    de reportes, a partir del cual isReportDue() cuenta HEARTBEAT_TIMEOUT. Se usa el instante
+    programado de TASK_REPORT y no millis(): el paquete sale unos ms después del cierre,
+    por lo que, contando desde millis(), el latido se demoraría una ventana completa.
+*/
+void rememberReportSent() {
+    #if LORA_REPORT_MODE == REPORT_MODE_EXCEPTION
+        // schedulerRun() ya avanzó due al próximo vencimiento.
+        const Task& task = scheduler.tasks[TASK_REPORT];
+        lastReportMillis = task.due - task.period;
+    #endif
+}
+
+/**
+    pushBatchWindow() agrega una ventana al final del anillo de ventanas pendientes de envío.
+    Si el anillo está lleno (LORA_BATCH_MAX ventanas), se descarta la más antigua.
+    @param current Corriente de la ventana (ver reduceCurrent()).
+    @param raindrop Resultado de la votación de lluvia de la ventana.
+    @param gas Combustible de la ventana.
+*/
+void pushBatchWindow(const WindowCurrent& current, int raindrop, float gas) {
+    batchCurrents[batchHead] = current;
+    batchRaindrops[batchHead] = raindrop;
+    batchGas[batchHead] = gas;
+    batchMillis[batchHead] = millis();
+
+    batchHead = (batchHead + 1) % LORA_BATCH_MAX;
+    if (batchCount < LORA_BATCH_MAX) {
+        batchCount++;
+    } else {
+        #if DEBUG_LEVEL >= 1
+            Serial.println("Anillo de ventanas lleno, se descarta la más antigua!");
+        #endif
+    }
+}
+
+/**
+    batchWindow() obtiene la posición dentro del anillo de la i-ésima ventana pendiente,
+    contando desde la más antigua (i = 0) hasta la más reciente (i = batchCount - 1).
+    @param i Orden de la ventana.
+    @return Índice de la ventana en batchCurrents, batchRaindrops, batchGas y batchMillis.
+*/
+int batchWindow(int i) {
+    return (batchHead - batchCount + i + LORA_BATCH_MAX) % LORA_BATCH_MAX;
+}
+
+/**
+    batchWindowAge() calcula los segundos transcurridos desde el cierre de una ventana pendiente.
+    @param i Orden de la ventana (ver batchWindow()).
+    @return Segundos desde el cierre de la ventana (redondeados).
+*/
+unsigned int batchWindowAge(int i) {
+    return (millis() - batchMillis[batchWindow(i)] + 500) / 1000;
+}
+
+/**
+    isBatchDue() decide si corresponde transmitir las ventanas pendientes del anillo:
+        - si se juntaron reportBatchSize ventanas,
+        - con LORA_REPORT_MODE == REPORT_MODE_EXCEPTION, además, apenas se encola una ventana
+          (un cambio o un heartbeat no espera a que se junten las demás), o si la ventana
+          pendiente más antigua se cerró hace HEARTBEAT_TIMEOUT segundos o más (por ejemplo,
+          porque el SX1278 estaba ocupado cuando se encoló).
+    Es decir, en modo por excepción sólo se agrupan las ventanas que no pudieron transmitirse.
+    @param queued true si se acaba de encolar una ventana (ver isReportDue()).
+    @return true si hay que transmitir las ventanas pendientes.
+*/
+bool isBatchDue(bool queued) {
+    if (batchCount == 0) {
+        return false;
+    }
+    if (batchCount >= reportBatchSize) {
+        return true;
+    }
+    #if LORA_REPORT_MODE == REPORT_MODE_EXCEPTION
+        return queued || batchWindowAge(0) >= HEARTBEAT_TIMEOUT;
+    #else
+        (void)queued;
+        return false;
+    #endif
+}
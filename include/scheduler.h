@@ -0,0 +1,201 @@
+/**
+    Header que contiene un planificador cooperativo de tareas periódicas: cada tarea tiene
+    un período, una fase (demora hasta su primer vencimiento) y una prioridad, y se guarda
+    en una cola ordenada por vencimiento (y por prioridad, entre las que vencen juntas).
+    schedulerRun() ejecuta las tareas vencidas y schedulerIdle() indica cuánto falta para
+    el próximo vencimiento, es decir, cuánto puede esperar loop() sin atrasar ninguna tarea.
+    Cada vencimiento se calcula sumando el período al anterior (no al instante en que la tarea
+    efectivamente se ejecutó), por lo que los períodos no acumulan atraso, y todas las
+    comparaciones son por diferencia, por lo que funciona igual cuando millis() desborda
+    (cada 49,7 días), siempre que los períodos sean menores a 2^31 ms.
+    Al igual que stats_helpers.h, no depende de Arduino: el instante actual (en ms) es un parámetro.
+    @file scheduler.h
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+
+#ifndef SCHEDULER_TASKS
+#define SCHEDULER_TASKS 8            // Cantidad de tareas (identificadores 0 a SCHEDULER_TASKS - 1).
+#endif
+#define SCHEDULER_NEVER 0xFFFFFFFFUL // schedulerIdle() sin tareas en la cola.
+
+/**
+    TaskFunction es la función que ejecuta una tarea cuando vence.
+*/
+typedef void (*TaskFunction)();
+
+/**
+    Task contiene el estado de una tarea.
+*/
+struct Task {
+    TaskFunction run;   // Función de la tarea.
+    uint32_t period;    // Período (en ms), o 0 para una tarea que se ejecuta una única vez.
+    uint32_t due;       // Instante del próximo vencimiento (en ms).
+    uint8_t priority;   // Prioridad entre tareas que vencen juntas (0 es la más prioritaria).
+    bool queued;        // true mientras la tarea esté en la cola.
+};
+
+/**
+    Scheduler contiene las tareas y la cola de identificadores ordenada por vencimiento.
+*/
+struct Scheduler {
+    Task tasks[SCHEDULER_TASKS];
+    uint8_t queue[SCHEDULER_TASKS]; // Identificadores de las tareas en la cola, la próxima primero.
+    uint8_t queued;                 // Cantidad de tareas en la cola.
+};
+
+/**
+    taskBefore() determina si una tarea debe ejecutarse antes que otra.
+    @param a Tarea.
+    @param b Tarea.
+    @return true si a vence antes que b o, si vencen juntas, si a es más prioritaria.
+*/
+inline bool taskBefore(const Task& a, const Task& b) {
+    int32_t difference = (int32_t)(a.due - b.due);
+    return difference < 0 || (difference == 0 && a.priority < b.priority);
+}
+
+/**
+    schedulerDequeue() saca una tarea de la cola (si estaba).
+    @param &scheduler Dirección de memoria del planificador.
+    @param id Identificador de la tarea.
+*/
+inline void schedulerDequeue(Scheduler& scheduler, uint8_t id) {
+    if (!scheduler.tasks[id].queued) {
+        return;
+    }
+    uint8_t i = 0;
+    while (scheduler.queue[i] != id) {
+        i++;
+    }
+    for (scheduler.queued--; i < scheduler.queued; i++) {
+        scheduler.queue[i] = scheduler.queue[i + 1];
+    }
+    scheduler.tasks[id].queued = false;
+}
+
+/**
+    schedulerEnqueue() inserta una tarea en la cola, en la posición que le corresponde
+    según su vencimiento y su prioridad.
+    @param &scheduler Dirección de memoria del planificador.
+    @param id Identificador de la tarea (que no debe estar en la cola).
+*/
+inline void schedulerEnqueue(Scheduler& scheduler, uint8_t id) {
+    uint8_t i = scheduler.queued;
+    while (i > 0 && taskBefore(scheduler.tasks[id], scheduler.tasks[scheduler.queue[i - 1]])) {
+        scheduler.queue[i] = scheduler.queue[i - 1];
+        i--;
+    }
+    scheduler.queue[i] = id;
+    scheduler.queued++;
+    scheduler.tasks[id].queued = true;
+}
+
+/**
+    schedulerReset() vacía un planificador.
+    @param &scheduler Dirección de memoria del planificador.
+*/
+inline void schedulerReset(Scheduler& scheduler) {
+    for (uint8_t id = 0; id < SCHEDULER_TASKS; id++) {
+        scheduler.tasks[id].run = 0;
+        scheduler.tasks[id].queued = false;
+    }
+    scheduler.queued = 0;
+}
+
+/**
+    taskStart() (re)programa una tarea: su primer vencimiento es phase ms después de now
+    y los siguientes, cada period ms. Si la tarea ya estaba programada, se reemplaza.
+    Por ejemplo:
+        taskStart(scheduler, 0, blink, 500, 0, 1, millis());
+    Ejecuta blink() ahora y luego cada 500 ms.
+    @param &scheduler Dirección de memoria del planificador.
+    @param id Identificador de la tarea (0 a SCHEDULER_TASKS - 1).
+    @param run Función de la tarea.
+    @param period Período (en ms), o 0 para ejecutarla una única vez.
+    @param phase Demora hasta el primer vencimiento (en ms).
+    @param priority Prioridad entre tareas que vencen juntas (0 es la más prioritaria).
+    @param now Instante actual (en ms).
+*/
+inline void taskStart(Scheduler& scheduler, uint8_t id, TaskFunction run, uint32_t period,
+    uint32_t phase, uint8_t priority, uint32_t now) {
+    schedulerDequeue(scheduler, id);
+    Task& task = scheduler.tasks[id];
+    task.run = run;
+    task.period = period;
+    task.due = now + phase;
+    task.priority = priority;
+    schedulerEnqueue(scheduler, id);
+}
+
+/**
+    taskStop() deja de ejecutar una tarea (hasta el próximo taskStart()).
+    @param &scheduler Dirección de memoria del planificador.
+    @param id Identificador de la tarea.
+*/
+inline void taskStop(Scheduler& scheduler, uint8_t id) {
+    schedulerDequeue(scheduler, id);
+}
+
+/**
+    taskActive() determina si una tarea está programada.
+    @param scheduler Planificador.
+    @param id Identificador de la tarea.
+    @return true si la tarea está en la cola.
+*/
+inline bool taskActive(const Scheduler& scheduler, uint8_t id) {
+    return scheduler.tasks[id].queued;
+}
+
+/**
+    schedulerRun() ejecuta, en orden, las tareas vencidas. Antes de ejecutar cada una,
+    la reprograma un período después de su vencimiento; si se atrasó uno o más períodos
+    completos, se saltean (se ejecuta una sola vez y conserva su fase).
+    Una tarea puede llamar a taskStart() o a taskStop() (incluso sobre sí misma); para que
+    una tarea que se reprograma sin demora no bloquee a loop(), cada llamada ejecuta
+    a lo sumo SCHEDULER_TASKS tareas.
+    @param &scheduler Dirección de memoria del planificador.
+    @param now Instante actual (en ms).
+    @return Cantidad de tareas ejecutadas.
+*/
+inline uint8_t schedulerRun(Scheduler& scheduler, uint32_t now) {
+    uint8_t executed = 0;
+    while (scheduler.queued > 0 && executed < SCHEDULER_TASKS) {
+        uint8_t id = scheduler.queue[0];
+        Task& task = scheduler.tasks[id];
+        if ((int32_t)(now - task.due) < 0) {
+            break;
+        }
+        schedulerDequeue(scheduler, id);
+        if (task.period > 0) {
+            task.due += task.period * ((now - task.due) / task.period + 1);
+            schedulerEnqueue(scheduler, id);
+        }
+        task.run();
+        executed++;
+    }
+    return executed;
+}
+
+/**
+    schedulerIdle() obtiene cuánto falta para el próximo vencimiento.
+    @param scheduler Planificador.
+    @param now Instante actual (en ms).
+    @return Tiempo hasta el próximo vencimiento (en ms; 0 si alguna tarea está vencida),
+    o SCHEDULER_NEVER si no hay tareas programadas.
+*/
+inline uint32_t schedulerIdle(const Scheduler& scheduler, uint32_t now) {
+    if (scheduler.queued == 0) {
+        return SCHEDULER_NEVER;
+    }
+    int32_t remaining = (int32_t)(scheduler.tasks[scheduler.queue[0]].due - now);
+    return remaining > 0 ? (uint32_t)remaining : 0;
+}
+
+#endif
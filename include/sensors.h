@@ -3,17 +3,16 @@
     @file sensors.h
     @author Franco Abosso
     @author Julio Donadello
-    @version 1.0 29/03/2021
+    @version 1.1 16/10/2026
 */
 
 /**
     refreshAllSensors() se encarga de pedir el refresco de todos los sensores,
-    poniendo cada uno de los flags del vector refreshRequested en true.
+    dejando pendientes sus eventos (EVENT_CURRENT y EVENT_RAIN).
 */
 void refreshAllSensors() {
-    for (int i = 0; i < SENSORS_QTY; i++) {
-        refreshRequested[i] = true;
-    }
+    eventPost(EVENT_CURRENT);
+    eventPost(EVENT_RAIN);
     #if DEBUG_LEVEL >= 2
         Serial.println("Refrescando sensores!");
     #endif
@@ -21,84 +20,190 @@ void refreshAllSensors() {
 
 /**
     stopRefreshingAllSensors() se encarga de parar el refresco de todos los sensores,
-    poniendo cada uno de los flags del vector refreshRequested en false.
+    bajando sus eventos (EVENT_CURRENT y EVENT_RAIN).
 */
 void stopRefreshingAllSensors() {
-    for (int i = 0; i < SENSORS_QTY; i++) {
-        refreshRequested[i] = false;
-    }
+    eventClear(EVENT_CURRENT);
+    eventClear(EVENT_RAIN);
     #if DEBUG_LEVEL >= 2
         Serial.println("Abandonando refrescos!");
     #endif
 }
 
 /**
-    getNewCurrent() se encarga de agregar un nuevo valor en el array de medición de tensión.
-    Luego de hacerlo, baja el flag correspondiente en refreshRequested.
+    getNewCurrent() se encarga de agregar un nuevo valor de corriente a las estadísticas
+    de la ventana actual (currentStats). Las mediciones que no superan THRESHOLD_NOISE_CURRENT
+    se agregan como 0.
+    Luego de hacerlo, baja EVENT_CURRENT.
 */
 void getNewCurrent() {
     float newCurrent = 0.0;
-    if (index < ARRAY_SIZE) {
+    #ifndef CORRIENTE_MOCK
+        newCurrent = eMon.Irms;
+        if (newCurrent <= THRESHOLD_NOISE_CURRENT) {
+            statsAdd(currentStats, 0.0);
+        } else {
+            statsAdd(currentStats, newCurrent);
+        }
+    #else
+        newCurrent = CORRIENTE_MOCK + random(30) / 100.0;
+        statsAdd(currentStats, newCurrent);
+    #endif
+    #if DEBUG_LEVEL >= 3
+        Serial.print("Nueva corriente: ");
+        Serial.println(newCurrent);
         #ifndef CORRIENTE_MOCK
-            newCurrent = eMon.Irms;
-            if (newCurrent <= THRESHOLD_NOISE_CURRENT) {
-                currents[index] = 0.001;
-            } else {
-                currents[index] = newCurrent;
+            Serial.print("Tensión de alimentación: ");
+            Serial.print(eMon.cachedVcc());
+            Serial.println(" mV");
+        #endif
+    #endif
+    eventClear(EVENT_CURRENT);
+}
+
+/**
+    currentObserver() es el manejador de EVENT_CURRENT: obtiene un nuevo valor de corriente,
+    de a EMON_SAMPLES_PER_LOOP muestras por pasada (ver getNewCurrent()).
+*/
+void currentObserver() {
+    PROFILE(PROBE_CURRENT);
+    #ifndef CORRIENTE_MOCK
+        if (!eMon.measuring()) {
+            eMon.beginI(EMON_CROSSINGS, EMON_TIMEOUT);
+            #if ADC_SAMPLING == ADC_SAMPLING_ENGINE
+                // Las muestras acumuladas desde la medición anterior no son contiguas.
+                adcFlush(CORRIENTE_PIN);
+            #endif
+        }
+        if (eMon.pollVI(EMON_SAMPLES_PER_LOOP)) {
+            getNewCurrent();
+        }
+    #else
+        getNewCurrent();
+    #endif
+}
+
+/**
+    getNewRaindrop() se encarga de agregar un nuevo voto de lluvia a rainVotes,
+    basándose en la medición actual del puerto analógico LLUVIA_PIN y en el umbral
+    LLUVIA_THRESHOLD_10BIT configurado, con una histéresis de ±LLUVIA_HYSTERESIS_10BIT:
+    el sensor sólo pasa a mojado (rainWet) al cruzar el umbral más la histéresis
+    y sólo vuelve a seco al cruzarlo de vuelta más la histéresis, por lo que una muestra
+    cercana al umbral vota igual que la anterior.
+    Es el manejador de EVENT_RAIN: luego de hacerlo, baja el evento.
+*/
+void getNewRaindrop() {
+    PROFILE(PROBE_RAIN);
+    #ifndef RAINDROP_MOCK
+        int raindrop = adcRead(LLUVIA_PIN);
+        #if LLUVIA_ACTIVO == HIGH
+            if (raindrop >= LLUVIA_THRESHOLD_10BIT + LLUVIA_HYSTERESIS_10BIT) {
+                rainWet = true;
+            } else if (raindrop < LLUVIA_THRESHOLD_10BIT - LLUVIA_HYSTERESIS_10BIT) {
+                rainWet = false;
             }
         #else
-            newCurrent = CORRIENTE_MOCK + random(30) / 100.0;
-            currents[index] = newCurrent;
-        #endif
-        #if DEBUG_LEVEL >= 3
-            Serial.print("Nueva corriente: ");
-            Serial.println(newCurrent);
+            if (raindrop < LLUVIA_THRESHOLD_10BIT - LLUVIA_HYSTERESIS_10BIT) {
+                rainWet = true;
+            } else if (raindrop >= LLUVIA_THRESHOLD_10BIT + LLUVIA_HYSTERESIS_10BIT) {
+                rainWet = false;
+            }
         #endif
+        votesAdd(rainVotes, rainWet);
+    #endif
+    eventClear(EVENT_RAIN);
+}
+
+/**
+    echoCheck() es la función que NewPing llama desde la interrupción de Timer2
+    (cada ECHO_TIMER_FREQ us) mientras espera el eco de un ping disparado con ping_timer().
+    Al recibirlo, guarda su tiempo en pingEcho y pone pingDone en true.
+*/
+void echoCheck() {
+    if (sonar.check_timer()) {
+        pingEcho = sonar.ping_result;
+        pingDone = true;
     }
-    refreshRequested[0] = false;
 }
 
 /**
-    getNewRaindrop() se encarga de agregar un nuevo valor en el array de lluvia,
-    basándose en la medición actual del puerto analógico LLUVIA_PIN y en el umbral 
-    LLUVIA_THRESHOLD_10BIT configurado.
-    Luego de hacerlo, baja el flag correspondiente en refreshRequested.
+    addPingTime() agrega un tiempo de eco a pingTimes, manteniéndolo ordenado en forma descendente
+    (el mismo ordenamiento por inserción que NewPing::ping_median(), pero de a un eco por vez).
+    @param echo Tiempo de eco (en us).
 */
-void getNewRaindrop() {
-    #ifndef RAINDROP_MOCK
-        if (index < ARRAY_SIZE) {
-            #if LLUVIA_ACTIVO == HIGH
-                if (analogRead(LLUVIA_PIN) >= LLUVIA_THRESHOLD_10BIT) {
-                    raindrops[index] = 1;
-                } else {
-                    raindrops[index] = 0;
-                }
-            #else
-                if (analogRead(LLUVIA_PIN) < LLUVIA_THRESHOLD_10BIT) {
-                    raindrops[index] = 1;
-                } else {
-                    raindrops[index] = 0;
-                }
-            #endif
+void addPingTime(unsigned int echo) {
+    uint8_t i = pingsEchoed;
+    for (; i > 0 && pingTimes[i - 1] < echo; i--) {
+        pingTimes[i] = pingTimes[i - 1];
+    }
+    pingTimes[i] = echo;
+    pingsEchoed++;
+}
+
+/**
+    pollGas() avanza la medición asíncrona de combustible: dispara PING_SAMPLES pings con
+    sonar.ping_timer(), separados por PING_MEDIAN_DELAY us, y agrega cada eco que detecta
+    echoCheck() a pingTimes. Un ping sin eco dentro de PING_MEDIAN_DELAY us se descarta,
+    como en NewPing::ping_median().
+    Nunca espera un eco: sólo demora lo que tarda el HC-SR04 en empezar a responder cada trigger.
+    Si no hay una medición en curso, inicia una nueva.
+    @return true cuando la medición terminó (ver pingMedian()), false mientras esté en curso.
+*/
+boolean pollGas() {
+    uint32_t now = micros();
+    if (gasState == GAS_ECHO) {
+        if (pingDone) {
+            addPingTime(pingEcho);
+        } else if (now - pingMicros < PING_MEDIAN_DELAY) {
+            return false;
+        } else {
+            // Sin eco: detiene Timer2, por si la interrupción todavía no vio el timeout de NewPing.
+            sonar.timer_stop();
         }
-    #endif
-    refreshRequested[1] = false;
+        gasState = GAS_PAUSE;
+    }
+    if (gasState == GAS_PAUSE) {
+        if (pingsFired >= PING_SAMPLES) {
+            gasState = GAS_IDLE;
+            return true;
+        }
+        if (now - pingMicros < PING_MEDIAN_DELAY) {
+            return false;
+        }
+    } else {
+        pingsFired = 0;
+        pingsEchoed = 0;
+    }
+    pingDone = false;
+    pingMicros = now;
+    pingsFired++;
+    gasState = GAS_ECHO;
+    sonar.ping_timer(echoCheck);
+    return false;
+}
+
+/**
+    pingMedian() obtiene la mediana de los tiempos de eco de la última medición de combustible.
+    @return Mediana (en us), o NO_ECHO si ningún ping tuvo eco.
+*/
+unsigned int pingMedian() {
+    return pingsEchoed ? pingTimes[pingsEchoed >> 1] : NO_ECHO;
 }
 
 /**
     getNewGas() se encarga de obtener el nivel de combustible actual,
-    luego de promediar la cantidad de tiempos de eco ultrasónico definidos por PING_SAMPLES,
+    a partir de la mediana de los tiempos de eco ultrasónico de la última medición (ver pollGas()),
     basándose en la relación entre:
     - la diferencia de tiempos entre el eco ultrasónico actual (timeUltrasonic) y el tiempo 
     medido en vacío (T_VACIO), y
     - la diferencia de tiempos entre el tiempo medido en vacío y el tiempo medido en lleno (T_LLENO).
     multiplicada por una constante, la capacidad del tanque en litros (CAPACIDAD_COMBUSTIBLE).
-    Luego de hacerlo, baja el flag gasRequested correspondiente.
+    Luego de hacerlo, baja EVENT_GAS.
 */
 void getNewGas() {
     float timeUltrasonic = 0.0;
     #ifndef GAS_MOCK
-        timeUltrasonic = sonar.ping_median(PING_SAMPLES);
+        timeUltrasonic = pingMedian();
         if (timeUltrasonic < TIME_LLENO) {
             gas = float(CAPACIDAD_COMBUSTIBLE);
         } else if (timeUltrasonic > TIME_VACIO) {
@@ -115,18 +220,64 @@ void getNewGas() {
         Serial.println(String(timeUltrasonic) + " us");
         Serial.println(String(gas) + " litros");
     #endif
-    gasRequested = false;
+    eventClear(EVENT_GAS);
+}
+
+/**
+    gasObserver() es el manejador de EVENT_GAS: obtiene un nuevo valor de combustible,
+    sin esperar los ecos ultrasónicos (ver pollGas()).
+*/
+void gasObserver() {
+    PROFILE(PROBE_GAS);
+    #ifndef GAS_MOCK
+        if (pollGas()) {
+            getNewGas();
+        }
+    #else
+        getNewGas();
+    #endif
 }
 
 /**
     getNewGPS() se encarga de leer la información proveniente del puerto
-    serial correspondiente al GPS (ssGPS) y encodear esa información a un
+    serial correspondiente al GPS (ver gps_uart.h) y encodear esa información a un
     objeto que organiza esos datos (GPS).
+    Los caracteres se encodean de a bloques de hasta GPS_CHUNK_SIZE caracteres.
+    Se ejecuta en cada pasada de loop(), haya o no un pedido de posición (EVENT_GPS),
+    para que no se acumulen caracteres sin procesar.
 */
 void getNewGPS() {
     #ifndef GPS_MOCK
-        while (ssGPS.available() > 0) {
-            GPS.encode(ssGPS.read());
+        PROFILE(PROBE_GPS);
+        char chunk[GPS_CHUNK_SIZE];
+        size_t length;
+        while ((length = gpsUartRead(chunk, sizeof(chunk))) > 0) {
+            GPS.encode(chunk, length);
         }
     #endif
-}
\ No newline at end of file
+}
+
+/**
+    gpsFixObserver() es el manejador de EVENT_GPS (pedido de posición): baja el evento una vez
+    recibida una sentencia con posición, es decir, cuando GPS.sentencesWithFix() deja de valer
+    GPSRequestFixes. Con GPS_POWER_SAVE, también desiste de la posición luego de GPS_FIX_TIMEOUT ms
+    (ver powerObserver()).
+*/
+void gpsFixObserver() {
+    #ifndef GPS_MOCK
+        bool fixed = GPS.sentencesWithFix() != GPSRequestFixes;
+    #else
+        bool fixed = true;
+    #endif
+    #if GPS_POWER_SAVE
+        if (!fixed && millis() - GPSRequestMillis >= GPS_FIX_TIMEOUT) {
+            #if DEBUG_LEVEL >= 1
+                Serial.println("Timeout de posición GPS!");
+            #endif
+            fixed = true;
+        }
+    #endif
+    if (fixed) {
+        eventClear(EVENT_GPS);
+    }
+}
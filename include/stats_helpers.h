@@ -0,0 +1,154 @@
+/**
+    Header que contiene acumuladores en línea, que procesan cada valor en O(1) y en memoria
+    constante, sin guardar los valores (la longitud de la ventana de medición no depende
+    del tamaño de ningún array):
+        - RunningStats: cantidad, media, mínimo, máximo y varianza (algoritmo de Welford),
+        - VoteCounter: votación por mayoría entre votos positivos y negativos.
+    Al igual que binary_payload.h, no depende de Arduino ni de constants.h.
+    @file stats_helpers.h
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+#ifndef STATS_HELPERS_H
+#define STATS_HELPERS_H
+
+#include <math.h>
+#include <stdint.h>
+
+/**
+    RunningStats contiene el estado del acumulador.
+    m2 es la suma de los cuadrados de las diferencias respecto de la media (ver statsAdd()).
+*/
+struct RunningStats {
+    unsigned int count; // Cantidad de valores agregados.
+    float mean;         // Media de los valores agregados.
+    float m2;           // Suma de (valor - media)^2.
+    float min;          // Mínimo de los valores agregados.
+    float max;          // Máximo de los valores agregados.
+};
+
+/**
+    statsReset() vacía un acumulador.
+    @param &stats Dirección de memoria del acumulador.
+*/
+inline void statsReset(RunningStats& stats) {
+    stats.count = 0;
+    stats.mean = 0.0;
+    stats.m2 = 0.0;
+    stats.min = 0.0;
+    stats.max = 0.0;
+}
+
+/**
+    statsAdd() agrega un valor al acumulador, actualizando la media y m2 con la recurrencia
+    de Welford, que no pierde precisión al restar sumas grandes como sum(x^2) - n * media^2:
+        delta = valor - media
+        media = media + delta / n
+        m2 = m2 + delta * (valor - media)
+    @param &stats Dirección de memoria del acumulador.
+    @param value Valor a agregar.
+*/
+inline void statsAdd(RunningStats& stats, float value) {
+    stats.count++;
+    float delta = value - stats.mean;
+    stats.mean += delta / stats.count;
+    stats.m2 += delta * (value - stats.mean);
+    if (stats.count == 1 || value < stats.min) {
+        stats.min = value;
+    }
+    if (stats.count == 1 || value > stats.max) {
+        stats.max = value;
+    }
+}
+
+/**
+    statsMean() obtiene la media de los valores agregados.
+    @param stats Acumulador.
+    @return Media, o NaN si no se agregó ningún valor.
+*/
+inline float statsMean(const RunningStats& stats) {
+    return stats.count ? stats.mean : NAN;
+}
+
+/**
+    statsMin() obtiene el mínimo de los valores agregados.
+    @param stats Acumulador.
+    @return Mínimo, o NaN si no se agregó ningún valor.
+*/
+inline float statsMin(const RunningStats& stats) {
+    return stats.count ? stats.min : NAN;
+}
+
+/**
+    statsMax() obtiene el máximo de los valores agregados.
+    @param stats Acumulador.
+    @return Máximo, o NaN si no se agregó ningún valor.
+*/
+inline float statsMax(const RunningStats& stats) {
+    return stats.count ? stats.max : NAN;
+}
+
+/**
+    statsStddev() obtiene el desvío estándar muestral de los valores agregados: sqrt(m2 / (n - 1)).
+    @param stats Acumulador.
+    @return Desvío estándar (0 con un único valor), o NaN si no se agregó ningún valor.
+*/
+inline float statsStddev(const RunningStats& stats) {
+    if (!stats.count) {
+        return NAN;
+    }
+    return stats.count > 1 ? sqrt(stats.m2 / (stats.count - 1)) : 0.0;
+}
+
+/**
+    VoteCounter contiene dos contadores saturados de votos: positivos (yes) y negativos (no).
+*/
+struct VoteCounter {
+    uint8_t yes;        // Cantidad de votos positivos.
+    uint8_t no;         // Cantidad de votos negativos.
+};
+
+/**
+    votesReset() vacía un contador de votos.
+    @param &votes Dirección de memoria del contador.
+*/
+inline void votesReset(VoteCounter& votes) {
+    votes.yes = 0;
+    votes.no = 0;
+}
+
+/**
+    votesAdd() agrega un voto. Si el contador del voto está por saturar, ambos contadores
+    se dividen por 2 antes de agregarlo, lo que conserva (aproximadamente) la proporción de votos.
+    @param &votes Dirección de memoria del contador.
+    @param vote true para un voto positivo, false para uno negativo.
+*/
+inline void votesAdd(VoteCounter& votes, bool vote) {
+    if ((vote ? votes.yes : votes.no) == UINT8_MAX) {
+        votes.yes >>= 1;
+        votes.no >>= 1;
+    }
+    if (vote) {
+        votes.yes++;
+    } else {
+        votes.no++;
+    }
+}
+
+/**
+    votesResult() obtiene el resultado de la votación.
+    Por ejemplo, con 1 voto positivo y 3 negativos, devuelve 0.
+    @param votes Contador.
+    @return 1 si ganan los votos positivos (también en caso de empate), 0 si ganan los negativos,
+    o -1 si no hubo votos.
+*/
+inline int votesResult(const VoteCounter& votes) {
+    if (!votes.yes && !votes.no) {
+        return -1;
+    }
+    return votes.no > votes.yes ? 0 : 1;
+}
+
+#endif
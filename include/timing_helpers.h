@@ -1,55 +1,143 @@
 /**
-    Header que contiene funcionalidades relacionadas al timing.
+    Header que contiene funcionalidades relacionadas al timing y al despacho de tareas y eventos.
     @file timing_helpers.h
     @author Franco Abosso
     @author Julio Donadello
-    @version 1.0 29/03/2021
+    @version 1.1 16/10/2026
 */
 
 /**
-    runEvery() utiliza una variable estática unsigned long para determinar
-    si pasaron determinada cantidad de milisegundos desde la última vez que ingresó.
-    Además, tiene un slot que permite escalar esta tarea.
-    Por ejemplo:
-        currentMillis = 32678
-        interval = 1000
-        slot = 1
-    Devuelve:
-        false (mientras currentMillis esté en el rango 32678 - 33677)
-        true (cuando currentMillis sea 33678 o más)
-    Antes de devolver true, se encarga de actualizar previousMillis del slot correspondiente.
-    La condición booleana debería utilizarse dentro de un condicional para que esta función tenga sentido.
+    taskEvery() programa una tarea del planificador global (scheduler) para que se ejecute
+    cada interval ms, empezando interval ms después de ahora, con prioridad igual a su identificador.
     Por ejemplo, el siguiente código:
-        if(runEvery(sec2ms(2), 1)) {
-            Serial.println("Hola");
-        }
-    Imprime por pantalla "Hola" cada 2 segundos.
-    @param interval Intervalo a esperar entre tarea y tarea.
-    @param slot Slot de timing seleccionado (permite múltiples "timers").
-    @return true o false, dependiendo de si ya es momento de repetir la tarea.
+        taskEvery(TASK_SENSORS, refreshTask, sec2ms(2));
+    Ejecuta refreshTask() cada 2 segundos (a los 2, 4, 6... segundos de llamarlo, sin atraso acumulado).
+    @param id Identificador de la tarea (ver TASK_REPORT y siguientes).
+    @param run Función de la tarea.
+    @param interval Intervalo entre ejecuciones (en ms).
+*/
+void taskEvery(uint8_t id, TaskFunction run, unsigned long interval) {
+    taskStart(scheduler, id, run, interval, interval, id, millis());
+}
+
+/**
+    runDueTasks() ejecuta las tareas vencidas del planificador global (ver schedulerRun()).
+*/
+void runDueTasks() {
+    schedulerRun(scheduler, millis());
+}
+
+/**
+    eventPost() deja pendiente un evento del despachador global (events), con las interrupciones
+    deshabilitadas para no perder un evento que levante una interrupción al mismo tiempo.
+    Desde una interrupción, alcanza con eventSet(events, id).
+    @param id Identificador del evento (ver EVENT_CURRENT y siguientes).
 */
-boolean runEvery(unsigned long interval, int slot) {
-    static unsigned long previousMillis[TIMING_SLOTS] = {0};
-    unsigned long currentMillis = millis();
-
-    if (slot <= TIMING_SLOTS) {
-        if (currentMillis - previousMillis[slot-1] >= interval) {
-            previousMillis[slot-1] = currentMillis;
-            return true;
-        } else {
-            return false;
+void eventPost(uint8_t id) {
+    noInterrupts();
+    eventSet(events, id);
+    interrupts();
+}
+
+/**
+    eventClear() deja de tener pendiente un evento del despachador global (ver eventPost()).
+    @param id Identificador del evento.
+*/
+void eventClear(uint8_t id) {
+    noInterrupts();
+    eventReset(events, id);
+    interrupts();
+}
+
+/**
+    runPendingEvents() ejecuta los manejadores de los eventos pendientes del despachador global
+    (ver eventsRun()). Mientras haya una alerta pedida o en curso, las mediciones quedan pendientes
+    hasta que termine.
+*/
+void runPendingEvents() {
+    uint8_t alerts = eventBit(EVENT_ALERT) | eventBit(EVENT_BUZZER);
+    uint8_t measurements = eventBit(EVENT_CURRENT) | eventBit(EVENT_RAIN) | eventBit(EVENT_GAS);
+    eventsRun(events, eventsAny(events, alerts) ? (uint8_t)~measurements : EVENTS_ALL);
+}
+
+#if PROFILER
+    /**
+        PROFILE() mide con una sonda de profile (PROBE_LOOP y siguientes, ver profiler.h)
+        el tiempo desde donde se escribe hasta el final del bloque. Por ejemplo:
+            void getNewRaindrop() {
+                PROFILE(PROBE_RAIN);
+                ...
+            }
+        micros() tiene una resolución de 4 us y cuesta unos 4 us, por lo que los bloques más
+        cortos se miden por exceso. Sin PROFILER, no genera código.
+    */
+    #define PROFILE(probe) ProfileScope profileScope(probe)
+
+    /**
+        ProfileScope mide el tiempo desde su construcción hasta su destrucción
+        y lo agrega a una sonda de profile (ver PROFILE()).
+    */
+    class ProfileScope {
+    public:
+        ProfileScope(uint8_t probe) : _probe(probe), _start(micros()) {}
+        ~ProfileScope() {
+            profileRecord(profile[_probe], micros() - _start);
         }
-    } else {
+    private:
+        uint8_t _probe;
+        uint32_t _start;
+    };
+
+    /**
+        profileDump() escribe sobre out el perfil del período actual, una sonda por línea:
+        nombre, cantidad de ejecuciones, tiempo medio, máximo y peor desde el arranque (en us)
+        e histograma, si PROFILER_BUCKETS > 0 (ver profiler.h). Por ejemplo:
+            "lp 612034 11 2904 8160 | 120 88 9 1 0 0 0 0"
+        @param &out Destino del perfil.
+    */
+    void profileDump(Print& out) {
+        // Los títulos van en la memoria flash (F()): sólo se imprimen cada PROFILER_DUMP_TIMEOUT.
+        out.print(F("Perfil: sonda cantidad media max peor"));
+        #if PROFILER_BUCKETS > 0
+            out.print(F(" | <16us <64us <256us <1ms <4ms <16ms <65ms resto"));
+        #endif
+        out.println();
+        for (uint8_t i = 0; i < PROFILER_PROBES; i++) {
+            out.print((const __FlashStringHelper*)profileNames[i]);
+            out.print(" ");
+            out.print(profile[i].count);
+            out.print(" ");
+            out.print(profileMean(profile[i]));
+            out.print(" ");
+            out.print(profile[i].max);
+            out.print(" ");
+            out.print(profile[i].worst);
+            #if PROFILER_BUCKETS > 0
+                out.print(" |");
+                for (uint8_t b = 0; b < PROFILER_BUCKETS; b++) {
+                    out.print(" ");
+                    out.print(profile[i].histogram[b]);
+                }
+            #endif
+            out.println();
+        }
+    }
+
+    /**
+        profileTask() es la tarea TASK_PROFILE: vuelca el perfil del período por puerto serial
+        (con DEBUG_LEVEL >= 1) y empieza el siguiente.
+    */
+    void profileTask() {
         #if DEBUG_LEVEL >= 1
-            Serial.println("TIMING_SLOTS mal configurado!");
-            Serial.print("Slot ingresado: ");
-            Serial.println(slot);
-            Serial.print("Slots reservados: ");
-            Serial.println(TIMING_SLOTS + 1);
+            profileDump(Serial);
         #endif
-        return false;
+        for (uint8_t i = 0; i < PROFILER_PROBES; i++) {
+            profileReset(profile[i]);
+        }
     }
-}
+#else
+    #define PROFILE(probe)
+#endif
 
 /**
     sec2ms() se encarga de convertir segundos a milisegundos.
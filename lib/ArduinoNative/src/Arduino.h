@@ -0,0 +1,125 @@
+/**
+    Reemplazo del core de Arduino para compilar y ejecutar el firmware en el host (env:native).
+    Sólo implementa la API que utilizan este proyecto y sus bibliotecas.
+    El tiempo es virtual: avanza cuando el código llama a delay(), analogRead(), SPI, etc.
+    o cuando el driver nativo lo indica (ver NativeHardware.h).
+    @file Arduino.h
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.1 16/10/2026
+*/
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "binary.h"
+
+typedef bool boolean;
+typedef uint8_t byte;
+typedef uint16_t word;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+#define LSBFIRST 0
+#define MSBFIRST 1
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define PI 3.1415926535897932384626433832795
+#define HALF_PI 1.5707963267948966192313216916398
+#define TWO_PI 6.283185307179586476925286766559
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+#ifndef F_CPU
+#define F_CPU 16000000UL // Reloj de un ATmega328 (Nano), el que suponen los costos de NativeHardware.h.
+#endif
+
+#define NUM_DIGITAL_PINS 22
+#define NOT_AN_INTERRUPT -1
+
+// Pines analógicos de un ATmega328 (Nano).
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+#define A6 20
+#define A7 21
+
+#define radians(deg) ((deg)*DEG_TO_RAD)
+#define degrees(rad) ((rad)*RAD_TO_DEG)
+#define sq(x) ((x)*(x))
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+
+#define lowByte(w) ((uint8_t) ((w) & 0xff))
+#define highByte(w) ((uint8_t) ((w) >> 8))
+
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+#define bit(b) (1UL << (b))
+
+#define digitalPinToInterrupt(p) ((p) == 2 ? 0 : ((p) == 3 ? 1 : NOT_AN_INTERRUPT))
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+// min() y max() como plantillas (y no como macros) para no romper los headers estándar del host.
+template<class T, class L>
+inline auto min(const T& a, const L& b) -> decltype((b < a) ? b : a) { return (b < a) ? b : a; }
+template<class T, class L>
+inline auto max(const T& a, const L& b) -> decltype((b < a) ? b : a) { return (a < b) ? b : a; }
+
+uint32_t millis();                          // De 32 bits, como unsigned long en AVR (ver NativeHardware.cpp).
+uint32_t micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+
+void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode);
+void detachInterrupt(uint8_t interruptNum);
+void interrupts();
+void noInterrupts();
+
+void randomSeed(unsigned long seed);
+long random(long howbig);
+long random(long howsmall, long howbig);
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+void setup();
+void loop();
+
+#include "WString.h"
+#include "HardwareSerial.h"
+
+#endif
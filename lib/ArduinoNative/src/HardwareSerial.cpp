@@ -0,0 +1,43 @@
+/**
+    Implementación del puerto serie físico para el host nativo.
+    @file HardwareSerial.cpp
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+#include "Arduino.h"
+#include "NativeHardware.h"
+
+#include <stdio.h>
+
+void HardwareSerial::begin(unsigned long baud) {
+    // 10 bits por byte (start + 8 datos + stop).
+    _byteTime = baud ? 10000000UL / baud : 0;
+    _drainedAt = nativeMicros();
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size) {
+    for (size_t i = 0; i < size && _byteTime; i++) {
+        unsigned long long now = nativeMicros();
+        if (_drainedAt < now) {
+            _drainedAt = now;
+        }
+        _drainedAt += _byteTime;
+        unsigned long long full = (unsigned long long)SERIAL_TX_BUFFER_SIZE * _byteTime;
+        if (_drainedAt - now > full) {
+            nativeAdvance(_drainedAt - now - full);
+        }
+    }
+    _bytesWritten += size;
+    if (_echo) {
+        fwrite(buffer, 1, size, stdout);
+    }
+    return size;
+}
+
+HardwareSerial Serial;
@@ -0,0 +1,47 @@
+/**
+    Reemplazo del puerto serie físico (Serial) para el host nativo.
+    Lo escrito se vuelca a stdout, salvo que se silencie con setEcho(false).
+    Modela el buffer de transmisión de 64 bytes del core AVR: si se llena,
+    write() bloquea (avanza el reloj virtual) al ritmo del bitrate configurado.
+    @file HardwareSerial.h
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+#ifndef HardwareSerial_h
+#define HardwareSerial_h
+
+#include "Stream.h"
+
+#define SERIAL_TX_BUFFER_SIZE 64
+
+class HardwareSerial : public Stream {
+public:
+    HardwareSerial() : _echo(true), _byteTime(0), _drainedAt(0), _bytesWritten(0) {}
+
+    void begin(unsigned long baud);
+    void end() {}
+
+    virtual int available() { return 0; }
+    virtual int read() { return -1; }
+    virtual int peek() { return -1; }
+    virtual size_t write(uint8_t c);
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    using Print::write;
+
+    void setEcho(bool echo) { _echo = echo; }
+    unsigned long bytesWritten() const { return _bytesWritten; }
+
+    operator bool() { return true; }
+
+private:
+    bool _echo;
+    unsigned long _byteTime;
+    unsigned long long _drainedAt;
+    unsigned long _bytesWritten;
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,378 @@
+/**
+    Implementación del modelo de hardware del host nativo y de la API de Arduino
+    que depende de él (tiempo, pines, interrupciones, números aleatorios).
+    @file NativeHardware.cpp
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.1 16/10/2026
+*/
+
+#include "Arduino.h"
+#include "NativeHardware.h"
+
+#include <stdio.h>
+
+#define NATIVE_PINS 32
+#define NATIVE_INTERRUPTS 2
+
+static unsigned long long clockNs = 0;
+static uint32_t millisOffset = 0;
+
+static NativeTicker *tickers = NULL;
+static bool skipping = false;
+
+static uint8_t pinModes[NATIVE_PINS];
+static uint8_t pinOutputs[NATIVE_PINS];
+static uint8_t pinInputs[NATIVE_PINS];
+static int analogValues[NATIVE_PINS];
+static bool analogValuesSet[NATIVE_PINS];
+static NativeAnalogSource analogSources[NATIVE_PINS];
+static unsigned long analogReadCount = 0;
+
+static void (*interruptHandlers[NATIVE_INTERRUPTS])(void);
+static bool interruptPending[NATIVE_INTERRUPTS];
+static bool interruptsEnabled = true;
+static bool inInterrupt = false;
+
+static bool watchdogEnabled = false;
+static unsigned long long watchdogTimeoutNs = 0;
+static unsigned long long watchdogLastResetNs = 0;
+
+static unsigned long randomState = 1;
+
+/// Tickers.
+
+NativeTicker::NativeTicker() {
+    _next = tickers;
+    tickers = this;
+}
+
+NativeTicker::~NativeTicker() {
+    NativeTicker **p = &tickers;
+    while (*p) {
+        if (*p == this) {
+            *p = _next;
+            break;
+        }
+        p = &(*p)->_next;
+    }
+}
+
+/// Reloj virtual.
+
+unsigned long long nativeNanos() {
+    return clockNs;
+}
+
+unsigned long long nativeMicros() {
+    return clockNs / 1000ULL;
+}
+
+void nativeAdvance(unsigned long long ns) {
+    nativeAdvanceTo(clockNs + ns);
+}
+
+/**
+    nativeAdvanceTo() lleva el reloj virtual hasta t, ejecutando en orden cronológico
+    los eventos de los modelos que vencen en el camino.
+    Los modelos deben actualizar su nextEvent() antes de disparar callbacks,
+    ya que éstos pueden volver a avanzar el reloj (por ejemplo, una ISR que usa SPI).
+*/
+void nativeAdvanceTo(unsigned long long t) {
+    while (true) {
+        NativeTicker *due = NULL;
+        unsigned long long dueAt = NATIVE_NEVER;
+        for (NativeTicker *p = tickers; p != NULL; p = p->_next) {
+            if (skipping && p->background()) {
+                continue;
+            }
+            unsigned long long at = p->nextEvent();
+            if (at <= t && at < dueAt) {
+                due = p;
+                dueAt = at;
+            }
+        }
+        if (due == NULL) {
+            break;
+        }
+        if (dueAt > clockNs) {
+            clockNs = dueAt;
+        }
+        due->onEvent(clockNs);
+    }
+    if (t > clockNs) {
+        clockNs = t;
+    }
+
+    if (watchdogEnabled && clockNs - watchdogLastResetNs > watchdogTimeoutNs) {
+        fprintf(stderr, "[native] watchdog reset a los %llu ms\n", clockNs / 1000000ULL);
+        exit(2);
+    }
+}
+
+/**
+    nativeSleep() modela al MCU dormido en SLEEP_MODE_IDLE: lleva el reloj virtual hasta
+    el próximo evento de algún modelo (la interrupción que lo despertaría) o, a lo sumo,
+    maxNs después de ahora (por ejemplo, el próximo desborde de Timer0).
+*/
+void nativeSleep(unsigned long long maxNs) {
+    unsigned long long wake = clockNs + maxNs;
+    for (NativeTicker *p = tickers; p != NULL; p = p->_next) {
+        unsigned long long at = p->nextEvent();
+        if (at < wake) {
+            wake = at;
+        }
+    }
+    nativeAdvanceTo(wake);
+}
+
+/**
+    nativeSkipTo() lleva el reloj virtual hasta t como nativeAdvanceTo(), pero sin ejecutar
+    los eventos de los modelos de fondo: a cada uno se le avisa con onSkip() al llegar a t.
+    Sirve para saltear intervalos en los que el programa no espera nada de esos modelos
+    (por ejemplo, el MCU en power-down, con el ADC apagado, o un arnés que adelanta el reloj).
+*/
+void nativeSkipTo(unsigned long long t) {
+    bool nested = skipping;
+    skipping = true;
+    nativeAdvanceTo(t);
+    skipping = nested;
+    if (!nested) {
+        for (NativeTicker *p = tickers; p != NULL; p = p->_next) {
+            if (p->background()) {
+                p->onSkip(clockNs);
+            }
+        }
+    }
+}
+
+/**
+    nativeNextEvent() obtiene el instante del próximo evento de los modelos que no son de fondo.
+    @param except Modelo que no se tiene en cuenta (NULL para ninguno).
+    @return Instante (en ns), o NATIVE_NEVER si no hay ninguno.
+*/
+unsigned long long nativeNextEvent(const NativeTicker *except) {
+    unsigned long long next = NATIVE_NEVER;
+    for (NativeTicker *p = tickers; p != NULL; p = p->_next) {
+        if (p != except && !p->background()) {
+            unsigned long long at = p->nextEvent();
+            if (at < next) {
+                next = at;
+            }
+        }
+    }
+    return next;
+}
+
+void nativeResetClock(unsigned long long t) {
+    clockNs = t;
+    watchdogLastResetNs = t;
+}
+
+void nativeSetMillisOffset(uint32_t ms) {
+    millisOffset = ms;
+}
+
+// Como en el ATmega328, millis() y micros() son de 32 bits y desbordan (a los 49,7 días y
+// a los 71,6 minutos), aunque en el host unsigned long sea de 64 bits.
+uint32_t millis() {
+    return (uint32_t)(clockNs / 1000000ULL) + millisOffset;
+}
+
+uint32_t micros() {
+    return (uint32_t)(clockNs / 1000ULL) + millisOffset * 1000UL;
+}
+
+void delay(unsigned long ms) {
+    nativeAdvance(ms * 1000000ULL);
+}
+
+void delayMicroseconds(unsigned int us) {
+    nativeAdvance(us * 1000ULL);
+}
+
+void yield() {
+    nativeAdvance(1000ULL);
+}
+
+/// Pines.
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin < NATIVE_PINS) {
+        pinModes[pin] = mode;
+    }
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    if (pin < NATIVE_PINS) {
+        pinOutputs[pin] = val ? HIGH : LOW;
+    }
+    nativeAdvance(NATIVE_COST_DIGITAL_WRITE_NS);
+}
+
+int digitalRead(uint8_t pin) {
+    nativeAdvance(NATIVE_COST_DIGITAL_READ_NS);
+    if (pin >= NATIVE_PINS) {
+        return LOW;
+    }
+    if (pinModes[pin] == OUTPUT) {
+        return pinOutputs[pin];
+    }
+    return pinInputs[pin];
+}
+
+int analogRead(uint8_t pin) {
+    int value = nativeAnalogSample(pin);
+    analogReadCount++;
+    nativeAdvance(NATIVE_COST_ANALOG_READ_NS);
+    return value;
+}
+
+int nativeAnalogSample(uint8_t pin) {
+    // El core acepta tanto el número de canal (0..7) como el de pin (A0..A7).
+    if (pin < A0) {
+        pin += A0;
+    }
+    int value = 512;
+    if (pin < NATIVE_PINS) {
+        if (analogSources[pin]) {
+            value = analogSources[pin](pin, nativeMicros());
+        } else if (analogValuesSet[pin]) {
+            value = analogValues[pin];
+        }
+    }
+    return constrain(value, 0, 1023);
+}
+
+void nativeSetAnalog(uint8_t pin, int value) {
+    if (pin < A0) {
+        pin += A0;
+    }
+    if (pin < NATIVE_PINS) {
+        analogValues[pin] = value;
+        analogValuesSet[pin] = true;
+        analogSources[pin] = NULL;
+    }
+}
+
+void nativeSetAnalogSource(uint8_t pin, NativeAnalogSource source) {
+    if (pin < A0) {
+        pin += A0;
+    }
+    if (pin < NATIVE_PINS) {
+        analogSources[pin] = source;
+    }
+}
+
+unsigned long nativeAnalogReads() {
+    return analogReadCount;
+}
+
+void nativeSetDigitalInput(uint8_t pin, int value) {
+    if (pin < NATIVE_PINS) {
+        pinInputs[pin] = value ? HIGH : LOW;
+    }
+}
+
+int nativeDigitalOutput(uint8_t pin) {
+    return pin < NATIVE_PINS ? pinOutputs[pin] : LOW;
+}
+
+/// Interrupciones.
+
+void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode) {
+    (void)mode;
+    if (interruptNum < NATIVE_INTERRUPTS) {
+        interruptHandlers[interruptNum] = userFunc;
+    }
+}
+
+void detachInterrupt(uint8_t interruptNum) {
+    if (interruptNum < NATIVE_INTERRUPTS) {
+        interruptHandlers[interruptNum] = NULL;
+        interruptPending[interruptNum] = false;
+    }
+}
+
+static void deliverPendingInterrupts() {
+    for (uint8_t i = 0; i < NATIVE_INTERRUPTS; i++) {
+        if (interruptPending[i] && interruptsEnabled && !inInterrupt) {
+            interruptPending[i] = false;
+            nativeRaiseInterrupt(i);
+        }
+    }
+}
+
+void nativeRaiseInterrupt(uint8_t interruptNum) {
+    if (interruptNum >= NATIVE_INTERRUPTS || interruptHandlers[interruptNum] == NULL) {
+        return;
+    }
+    if (!interruptsEnabled || inInterrupt) {
+        interruptPending[interruptNum] = true;
+        return;
+    }
+    inInterrupt = true;
+    interruptsEnabled = false;
+    interruptHandlers[interruptNum]();
+    interruptsEnabled = true;
+    inInterrupt = false;
+    deliverPendingInterrupts();
+}
+
+bool nativeInterruptsEnabled() {
+    return interruptsEnabled && !inInterrupt;
+}
+
+void interrupts() {
+    if (!inInterrupt) {
+        interruptsEnabled = true;
+        deliverPendingInterrupts();
+    }
+}
+
+void noInterrupts() {
+    interruptsEnabled = false;
+}
+
+/// Watchdog.
+
+void nativeWatchdogEnable(unsigned long timeoutMs) {
+    watchdogEnabled = true;
+    watchdogTimeoutNs = timeoutMs * 1000000ULL;
+    watchdogLastResetNs = clockNs;
+}
+
+void nativeWatchdogReset() {
+    watchdogLastResetNs = clockNs;
+}
+
+void nativeWatchdogDisable() {
+    watchdogEnabled = false;
+}
+
+/// Números aleatorios (generador congruencial, reproducible entre corridas).
+
+void randomSeed(unsigned long seed) {
+    if (seed != 0) {
+        randomState = seed;
+    }
+}
+
+long random(long howbig) {
+    if (howbig == 0) {
+        return 0;
+    }
+    randomState = randomState * 1103515245UL + 12345UL;
+    return (long)((randomState >> 16) & 0x7FFF) % howbig;
+}
+
+long random(long howsmall, long howbig) {
+    if (howsmall >= howbig) {
+        return howsmall;
+    }
+    return random(howbig - howsmall) + howsmall;
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
@@ -0,0 +1,82 @@
+/**
+    Header que contiene el modelo de hardware del host nativo:
+    reloj virtual, pines digitales y analógicos, interrupciones externas
+    y eventos programados de los modelos de periféricos (SX1278, timers, etc.).
+    El reloj virtual cuenta en nanosegundos y sólo avanza cuando alguien lo hace avanzar:
+    las llamadas bloqueantes (delay(), analogRead(), SPI, ...) suman su costo típico
+    en un ATmega328 a 16 MHz, y el driver (main nativo o un arnés) suma el resto.
+    @file NativeHardware.h
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.1 16/10/2026
+*/
+
+#ifndef NativeHardware_h
+#define NativeHardware_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+/// Costos aproximados (en ns) de las primitivas de Arduino en un ATmega328 a 16 MHz.
+#define NATIVE_COST_DIGITAL_WRITE_NS 3500UL   // digitalWrite() del core.
+#define NATIVE_COST_DIGITAL_READ_NS 3000UL    // digitalRead() del core.
+#define NATIVE_COST_ANALOG_READ_NS 112000UL   // analogRead() con prescaler 128 (13 ciclos de ADC + overhead).
+
+/**
+    NativeTicker es la interfaz de los modelos que necesitan ejecutar algo
+    en un instante dado del reloj virtual (por ejemplo, el fin de una transmisión LoRa).
+    nextEvent() devuelve el instante (en ns) del próximo evento, o NATIVE_NEVER si no hay ninguno.
+    Un modelo "de fondo" (background() en true, por ejemplo un muestreo periódico del que nadie
+    espera cada evento) puede saltearse: nativeSkipTo() no ejecuta sus eventos y, al terminar,
+    le avisa con onSkip() para que retome su fase a partir del nuevo instante.
+*/
+#define NATIVE_NEVER 0xFFFFFFFFFFFFFFFFULL
+
+class NativeTicker {
+public:
+    NativeTicker();
+    virtual ~NativeTicker();
+    virtual unsigned long long nextEvent() = 0;
+    virtual void onEvent(unsigned long long now) = 0;
+    virtual bool background() { return false; }
+    virtual void onSkip(unsigned long long now) { (void)now; }
+private:
+    NativeTicker *_next;
+    friend void nativeAdvanceTo(unsigned long long t);
+    friend void nativeSleep(unsigned long long maxNs);
+    friend void nativeSkipTo(unsigned long long t);
+    friend unsigned long long nativeNextEvent(const NativeTicker *except);
+};
+
+/// Reloj virtual.
+unsigned long long nativeNanos();
+unsigned long long nativeMicros();
+void nativeAdvance(unsigned long long ns);
+void nativeAdvanceTo(unsigned long long t);
+void nativeResetClock(unsigned long long t = 0);
+void nativeSetMillisOffset(uint32_t ms);   // millis() (y micros()) arrancan en ms, para probar su desborde.
+void nativeSleep(unsigned long long maxNs); // SLEEP_MODE_IDLE: hasta el próximo evento, a lo sumo maxNs.
+void nativeSkipTo(unsigned long long t);    // Como nativeAdvanceTo(), sin los eventos de los modelos de fondo.
+unsigned long long nativeNextEvent(const NativeTicker *except = NULL); // Próximo evento (sin los de fondo).
+
+/// Entradas analógicas: valor fijo o función del tiempo (en us).
+typedef int (*NativeAnalogSource)(uint8_t pin, unsigned long long us);
+void nativeSetAnalog(uint8_t pin, int value);
+void nativeSetAnalogSource(uint8_t pin, NativeAnalogSource source);
+unsigned long nativeAnalogReads();
+int nativeAnalogSample(uint8_t pin); // Conversión hecha por el periférico (sin costo para el programa).
+
+/// Entradas y salidas digitales.
+void nativeSetDigitalInput(uint8_t pin, int value);
+int nativeDigitalOutput(uint8_t pin);
+
+/// Interrupciones externas (INT0/INT1).
+void nativeRaiseInterrupt(uint8_t interruptNum);
+bool nativeInterruptsEnabled();
+
+/// Watchdog.
+void nativeWatchdogEnable(unsigned long timeoutMs);
+void nativeWatchdogReset();
+void nativeWatchdogDisable();
+
+#endif
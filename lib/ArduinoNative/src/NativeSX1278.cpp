@@ -0,0 +1,222 @@
+/**
+    Implementación del modelo de registros del SX1278 para el host nativo.
+    @file NativeSX1278.cpp
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+#include "Arduino.h"
+#include "NativeSX1278.h"
+
+#include <math.h>
+
+// Registros utilizados por el modelo (misma numeración que LoRa.cpp).
+#define REG_FIFO                 0x00
+#define REG_OP_MODE              0x01
+#define REG_FIFO_ADDR_PTR        0x0d
+#define REG_FIFO_TX_BASE_ADDR    0x0e
+#define REG_FIFO_RX_BASE_ADDR    0x0f
+#define REG_FIFO_RX_CURRENT_ADDR 0x10
+#define REG_IRQ_FLAGS            0x12
+#define REG_RX_NB_BYTES          0x13
+#define REG_MODEM_CONFIG_1       0x1d
+#define REG_MODEM_CONFIG_2       0x1e
+#define REG_PREAMBLE_MSB         0x20
+#define REG_PREAMBLE_LSB         0x21
+#define REG_PAYLOAD_LENGTH       0x22
+#define REG_MODEM_CONFIG_3       0x26
+#define REG_DIO_MAPPING_1        0x40
+#define REG_VERSION              0x42
+
+#define MODE_LONG_RANGE_MODE     0x80
+#define MODE_STDBY               0x01
+#define MODE_TX                  0x03
+#define MODE_RX_CONTINUOUS       0x05
+#define MODE_RX_SINGLE           0x06
+
+#define IRQ_TX_DONE_MASK         0x08
+#define IRQ_VALID_HEADER_MASK    0x10
+#define IRQ_RX_DONE_MASK         0x40
+
+NativeSX1278 SX1278;
+
+NativeSX1278::NativeSX1278() : _onTransmit(NULL) {
+    reset();
+}
+
+/**
+    reset() deja al chip con los valores de registro posteriores al power-on
+    que son relevantes para el modo LoRa.
+*/
+void NativeSX1278::reset() {
+    memset(_regs, 0, sizeof(_regs));
+    memset(_fifo, 0, sizeof(_fifo));
+    _regs[REG_OP_MODE] = 0x09;
+    _regs[0x09] = 0x4f;
+    _regs[0x0c] = 0x20;
+    _regs[REG_FIFO_TX_BASE_ADDR] = 0x80;
+    _regs[REG_MODEM_CONFIG_1] = 0x72;
+    _regs[REG_MODEM_CONFIG_2] = 0x70;
+    _regs[REG_PREAMBLE_LSB] = 0x08;
+    _regs[REG_PAYLOAD_LENGTH] = 0x01;
+    _regs[0x39] = 0x12;
+    _regs[REG_VERSION] = 0x12;
+    _selected = false;
+    _first = false;
+    _write = false;
+    _address = 0;
+    _txDoneAt = NATIVE_NEVER;
+    _airtimeUs = 0;
+    _packetsSent = 0;
+    _transactions = 0;
+    _bytes = 0;
+}
+
+void NativeSX1278::select() {
+    _selected = true;
+    _first = true;
+    _transactions++;
+}
+
+void NativeSX1278::deselect() {
+    _selected = false;
+}
+
+/**
+    transfer() procesa un byte de la transacción SPI en curso: el primero es la dirección
+    (bit 7 = escritura) y los siguientes, datos. En ráfaga, la dirección se incrementa
+    salvo para REG_FIFO, donde avanza REG_FIFO_ADDR_PTR.
+*/
+uint8_t NativeSX1278::transfer(uint8_t data) {
+    _bytes++;
+    if (!_selected) {
+        return 0;
+    }
+    if (_first) {
+        _first = false;
+        _write = (data & 0x80) != 0;
+        _address = data & 0x7f;
+        return 0;
+    }
+    uint8_t response;
+    if (_write) {
+        response = 0;
+        writeRegister(_address, data);
+    } else {
+        response = readRegister(_address);
+    }
+    if (_address != REG_FIFO) {
+        _address = (_address + 1) & 0x7f;
+    }
+    return response;
+}
+
+uint8_t NativeSX1278::readRegister(uint8_t address) {
+    if (address == REG_FIFO) {
+        return _fifo[_regs[REG_FIFO_ADDR_PTR]++];
+    }
+    return _regs[address];
+}
+
+void NativeSX1278::writeRegister(uint8_t address, uint8_t value) {
+    switch (address) {
+        case REG_FIFO:
+            _fifo[_regs[REG_FIFO_ADDR_PTR]++] = value;
+            break;
+        case REG_IRQ_FLAGS:
+            _regs[REG_IRQ_FLAGS] &= ~value;
+            break;
+        case REG_VERSION:
+            break;
+        case REG_OP_MODE: {
+            uint8_t previous = _regs[REG_OP_MODE] & 0x07;
+            _regs[REG_OP_MODE] = value;
+            if ((value & MODE_LONG_RANGE_MODE) && (value & 0x07) == MODE_TX && previous != MODE_TX) {
+                startTransmission();
+            } else if ((value & 0x07) != MODE_TX) {
+                _txDoneAt = NATIVE_NEVER;
+            }
+            break;
+        }
+        default:
+            _regs[address] = value;
+            break;
+    }
+}
+
+/**
+    computeAirtimeUs() calcula el time-on-air de un paquete con la fórmula de Semtech
+    (SX1276/77/78/79 datasheet, sección 4.1.1.7) y la configuración actual del módem.
+*/
+unsigned long NativeSX1278::computeAirtimeUs(uint8_t length) const {
+    static const double bandwidths[] = {7.8E3, 10.4E3, 15.6E3, 20.8E3, 31.25E3, 41.7E3, 62.5E3, 125E3, 250E3, 500E3};
+    int sf = _regs[REG_MODEM_CONFIG_2] >> 4;
+    int bwIndex = _regs[REG_MODEM_CONFIG_1] >> 4;
+    int cr = (_regs[REG_MODEM_CONFIG_1] >> 1) & 0x07;
+    int implicitHeader = _regs[REG_MODEM_CONFIG_1] & 0x01;
+    int crc = (_regs[REG_MODEM_CONFIG_2] >> 2) & 0x01;
+    int lowDataRate = (_regs[REG_MODEM_CONFIG_3] >> 3) & 0x01;
+    long preamble = ((long)_regs[REG_PREAMBLE_MSB] << 8) | _regs[REG_PREAMBLE_LSB];
+    double bw = bandwidths[bwIndex < 10 ? bwIndex : 9];
+
+    double symbol = (double)(1L << sf) / bw;
+    double preambleTime = (preamble + 4.25) * symbol;
+    double numerator = 8.0 * length - 4.0 * sf + 28 + 16 * crc - 20 * implicitHeader;
+    double symbols = 8 + fmax(ceil(numerator / (4.0 * (sf - 2 * lowDataRate))) * (cr + 4), 0);
+    return (unsigned long)((preambleTime + symbols * symbol) * 1E6 + 0.5);
+}
+
+void NativeSX1278::startTransmission() {
+    NativeLoRaPacket &packet = _packets[_packetsSent % NATIVE_SX1278_MAX_PACKETS];
+    uint8_t base = _regs[REG_FIFO_TX_BASE_ADDR];
+    packet.startUs = nativeMicros();
+    packet.length = _regs[REG_PAYLOAD_LENGTH];
+    for (int i = 0; i < packet.length; i++) {
+        packet.data[i] = _fifo[(uint8_t)(base + i)];
+    }
+    packet.airtimeUs = computeAirtimeUs(packet.length);
+    _airtimeUs += packet.airtimeUs;
+    _packetsSent++;
+    _txDoneAt = nativeNanos() + packet.airtimeUs * 1000ULL;
+    if (_onTransmit) {
+        _onTransmit(packet);
+    }
+}
+
+void NativeSX1278::onEvent(unsigned long long now) {
+    (void)now;
+    _txDoneAt = NATIVE_NEVER;
+    _regs[REG_IRQ_FLAGS] |= IRQ_TX_DONE_MASK;
+    _regs[REG_OP_MODE] = (_regs[REG_OP_MODE] & 0xf8) | MODE_STDBY;
+    if ((_regs[REG_DIO_MAPPING_1] >> 6) == 0x01) {
+        nativeRaiseInterrupt(NATIVE_SX1278_DIO0_INTERRUPT);
+    }
+}
+
+/**
+    injectPacket() simula la llegada de un paquete por aire.
+    Sólo se recibe si el chip está en modo RX (continuo o simple).
+    @return true si el paquete fue recibido.
+*/
+bool NativeSX1278::injectPacket(const uint8_t *data, uint8_t length) {
+    uint8_t currentMode = mode();
+    if (!(_regs[REG_OP_MODE] & MODE_LONG_RANGE_MODE) ||
+        (currentMode != MODE_RX_CONTINUOUS && currentMode != MODE_RX_SINGLE)) {
+        return false;
+    }
+    uint8_t base = _regs[REG_FIFO_RX_BASE_ADDR];
+    for (int i = 0; i < length; i++) {
+        _fifo[(uint8_t)(base + i)] = data[i];
+    }
+    _regs[REG_RX_NB_BYTES] = length;
+    _regs[REG_FIFO_RX_CURRENT_ADDR] = base;
+    _regs[REG_IRQ_FLAGS] |= IRQ_RX_DONE_MASK | IRQ_VALID_HEADER_MASK;
+    if (currentMode == MODE_RX_SINGLE) {
+        _regs[REG_OP_MODE] = (_regs[REG_OP_MODE] & 0xf8) | MODE_STDBY;
+    }
+    if ((_regs[REG_DIO_MAPPING_1] >> 6) == 0x00) {
+        nativeRaiseInterrupt(NATIVE_SX1278_DIO0_INTERRUPT);
+    }
+    return true;
+}
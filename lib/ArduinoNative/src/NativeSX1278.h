@@ -0,0 +1,90 @@
+/**
+    Header que contiene el modelo de registros del SX1278 (modo LoRa) para el host nativo.
+    Se conecta detrás de SPI, por lo que LoRaClass corre sin modificaciones:
+        - el FIFO, REG_FIFO_ADDR_PTR y las direcciones base se comportan como en el chip,
+        - las escrituras en ráfaga a REG_FIFO no incrementan la dirección (el resto sí),
+        - pasar a MODE_TX registra el paquete y, al cabo de su time-on-air, levanta
+          IRQ_TX_DONE, vuelve a standby y (si DIO0 está mapeado a TxDone) dispara INT0,
+        - injectPacket() simula la recepción de un paquete en modo RX.
+    Además cuenta transacciones y bytes SPI, para poder medir el costo de cada cambio.
+    @file NativeSX1278.h
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+#ifndef NativeSX1278_h
+#define NativeSX1278_h
+
+#include "NativeHardware.h"
+
+#define NATIVE_SX1278_MAX_PACKETS 64 // Paquetes transmitidos que se conservan (los más recientes).
+#define NATIVE_SX1278_DIO0_INTERRUPT 0 // DIO0 conectado a INT0 (pin D2).
+
+/**
+    NativeLoRaPacket describe un paquete transmitido por el nodo.
+*/
+struct NativeLoRaPacket {
+    unsigned long long startUs;  // Instante en que el chip pasó a MODE_TX.
+    unsigned long airtimeUs;     // Time-on-air calculado con la configuración vigente del módem.
+    uint8_t length;
+    uint8_t data[256];
+};
+
+class NativeSX1278 : public NativeTicker {
+public:
+    NativeSX1278();
+
+    void reset();
+
+    // Lado SPI.
+    void select();
+    uint8_t transfer(uint8_t data);
+    void deselect();
+
+    // Lado "aire".
+    bool injectPacket(const uint8_t *data, uint8_t length);
+    void onTransmit(void (*callback)(const NativeLoRaPacket &packet)) { _onTransmit = callback; }
+
+    unsigned long packetsSent() const { return _packetsSent; }
+    const NativeLoRaPacket &lastPacket() const { return _packets[(_packetsSent + NATIVE_SX1278_MAX_PACKETS - 1) % NATIVE_SX1278_MAX_PACKETS]; }
+    unsigned long long airtimeUs() const { return _airtimeUs; }
+
+    unsigned long spiTransactions() const { return _transactions; }
+    unsigned long spiBytes() const { return _bytes; }
+    void resetSpiCounters() { _transactions = 0; _bytes = 0; }
+
+    uint8_t mode() const { return _regs[0x01] & 0x07; }
+    uint8_t reg(uint8_t address) const { return _regs[address & 0x7f]; }
+
+    unsigned long computeAirtimeUs(uint8_t length) const;
+
+    // NativeTicker.
+    virtual unsigned long long nextEvent() { return _txDoneAt; }
+    virtual void onEvent(unsigned long long now);
+
+private:
+    uint8_t _regs[128];
+    uint8_t _fifo[256];
+    bool _selected;
+    bool _first;
+    bool _write;
+    uint8_t _address;
+
+    unsigned long long _txDoneAt;
+    unsigned long long _airtimeUs;
+    unsigned long _packetsSent;
+    NativeLoRaPacket _packets[NATIVE_SX1278_MAX_PACKETS];
+    void (*_onTransmit)(const NativeLoRaPacket &packet);
+
+    unsigned long _transactions;
+    unsigned long _bytes;
+
+    uint8_t readRegister(uint8_t address);
+    void writeRegister(uint8_t address, uint8_t value);
+    void startTransmission();
+};
+
+extern NativeSX1278 SX1278;
+
+#endif
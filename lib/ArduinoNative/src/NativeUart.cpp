@@ -0,0 +1,66 @@
+/**
+    Implementación del modelo de línea serie para el host nativo.
+    @file NativeUart.cpp
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+#include "NativeUart.h"
+
+NativeUartWire GPSWire;
+
+NativeUartWire::NativeUartWire() {
+    _byteTimeNs = 10000000000UL / 9600;
+    _lastArrivalNs = 0;
+    _receiver = NULL;
+    _received = 0;
+    _pendingFirstArrivalNs = 0;
+    _pendingHead = 0;
+    _pendingCount = 0;
+}
+
+void NativeUartWire::begin(long speed, NativeUartReceiver receiver) {
+    // 10 bits por byte (start + 8 datos + stop).
+    _byteTimeNs = 10000000000UL / (unsigned long)speed;
+    _receiver = receiver;
+}
+
+/**
+    feed() pone bytes "en el cable": el primero termina de llegar un tiempo de byte
+    después del último pendiente (o de ahora, si no hay ninguno).
+    @return Cantidad de bytes aceptados.
+*/
+size_t NativeUartWire::feed(const char *data, size_t length) {
+    if (_pendingCount == 0) {
+        unsigned long long now = nativeNanos();
+        _pendingFirstArrivalNs = (_lastArrivalNs > now ? _lastArrivalNs : now) + _byteTimeNs;
+    }
+    size_t accepted = 0;
+    while (accepted < length && _pendingCount < NATIVE_UART_MAX_PENDING) {
+        _pending[(_pendingHead + _pendingCount) % NATIVE_UART_MAX_PENDING] = data[accepted++];
+        _pendingCount++;
+    }
+    return accepted;
+}
+
+unsigned long long NativeUartWire::nextEvent() {
+    return _pendingCount > 0 ? _pendingFirstArrivalNs : NATIVE_NEVER;
+}
+
+/**
+    onEvent() entrega el byte que terminó de llegar. Sin receptor (begin() no fue llamado),
+    el byte se pierde, como en una línea que nadie escucha.
+*/
+void NativeUartWire::onEvent(unsigned long long now) {
+    (void)now;
+    uint8_t c = (uint8_t)_pending[_pendingHead];
+    _pendingHead = (_pendingHead + 1) % NATIVE_UART_MAX_PENDING;
+    _pendingCount--;
+    _lastArrivalNs = _pendingFirstArrivalNs;
+    _pendingFirstArrivalNs += _byteTimeNs;
+    if (_receiver != NULL) {
+        _receiver(c);
+        _received++;
+    }
+}
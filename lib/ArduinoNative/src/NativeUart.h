@@ -0,0 +1,57 @@
+/**
+    Header que contiene el modelo de una línea serie (UART) que llega a un pin del nodo,
+    para los drivers de recepción que no usan SoftwareSerial (por ejemplo, el de input capture
+    de Timer1 del GPS): los bytes que se entregan con feed() "llegan" al ritmo del bitrate
+    configurado y, al terminar de llegar cada uno, se le pasan al receptor indicado en begin(),
+    como lo haría la interrupción del driver real.
+    @file NativeUart.h
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+#ifndef NativeUart_h
+#define NativeUart_h
+
+#include "NativeHardware.h"
+
+#define NATIVE_UART_MAX_PENDING 4096 // Bytes "en el cable" que aún no llegaron.
+
+/**
+    NativeUartReceiver recibe cada byte que termina de llegar (en el instante del bit de stop).
+*/
+typedef void (*NativeUartReceiver)(uint8_t byte);
+
+class NativeUartWire : public NativeTicker {
+public:
+    NativeUartWire();
+
+    void begin(long speed, NativeUartReceiver receiver);
+
+    // Lado "cable".
+    size_t feed(const char *data, size_t length);
+    size_t pending() const { return _pendingCount; }
+    unsigned long received() const { return _received; }
+
+    // NativeTicker.
+    virtual unsigned long long nextEvent();
+    virtual void onEvent(unsigned long long now);
+
+private:
+    unsigned long _byteTimeNs;
+    unsigned long long _lastArrivalNs;
+    NativeUartReceiver _receiver;
+    unsigned long _received;
+
+    char _pending[NATIVE_UART_MAX_PENDING];
+    unsigned long long _pendingFirstArrivalNs;
+    size_t _pendingHead;
+    size_t _pendingCount;
+};
+
+/**
+    Línea serie del GPS (D8).
+*/
+extern NativeUartWire GPSWire;
+
+#endif
@@ -0,0 +1,173 @@
+/**
+    Implementación del reemplazo de NewPing para el host nativo.
+    @file NewPing.cpp
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+#include "NewPing.h"
+#include "NativeHardware.h"
+
+static unsigned int echoTime = NO_ECHO;
+static NativeEchoSource echoSource = NULL;
+
+void nativeSetEchoTime(unsigned int us) {
+    echoTime = us;
+    echoSource = NULL;
+}
+
+void nativeSetEchoSource(NativeEchoSource source) {
+    echoSource = source;
+}
+
+/**
+    PingTimer modela al Timer2 que NewPing usa en modo timer: llama a userFunc
+    periódicamente, como lo haría la ISR de comparación.
+*/
+class PingTimer : public NativeTicker {
+public:
+    PingTimer() : _userFunc(NULL), _periodNs(0), _nextNs(NATIVE_NEVER) {}
+    void start(unsigned long long periodNs, void (*userFunc)(void)) {
+        _userFunc = userFunc;
+        _periodNs = periodNs;
+        _nextNs = nativeNanos() + periodNs;
+    }
+    void stop() { _nextNs = NATIVE_NEVER; }
+    virtual unsigned long long nextEvent() { return _nextNs; }
+    virtual void onEvent(unsigned long long now) {
+        _nextNs = now + _periodNs;
+        if (_userFunc) {
+            _userFunc();
+        }
+    }
+private:
+    void (*_userFunc)(void);
+    unsigned long long _periodNs;
+    unsigned long long _nextNs;
+};
+
+static PingTimer pingTimer;
+
+NewPing::NewPing(uint8_t trigger_pin, uint8_t echo_pin, unsigned int max_cm_distance) {
+    pinMode(echo_pin, INPUT);
+    pinMode(trigger_pin, OUTPUT);
+    ping_result = 0;
+    _echoStartUs = 0;
+    _maxTimeUs = 0;
+    _echo = NO_ECHO;
+    set_max_distance(max_cm_distance);
+}
+
+void NewPing::set_max_distance(unsigned int max_cm_distance) {
+    _maxEchoTime = min(max_cm_distance, (unsigned int)MAX_SENSOR_DISTANCE) * US_ROUNDTRIP_CM + (US_ROUNDTRIP_CM / 2);
+}
+
+/**
+    trigger() emite el pulso de trigger y espera el inicio del eco.
+    @return Tiempo de eco que devolverá el sensor (NO_ECHO si no hay eco dentro del rango).
+*/
+unsigned int NewPing::trigger() {
+    delayMicroseconds(14 + NATIVE_PING_START_DELAY);
+    unsigned int echo = echoSource ? echoSource(nativeMicros()) : echoTime;
+    if (echo > _maxEchoTime) {
+        echo = NO_ECHO;
+    }
+    return echo;
+}
+
+unsigned int NewPing::ping(unsigned int max_cm_distance) {
+    if (max_cm_distance > 0) {
+        set_max_distance(max_cm_distance);
+    }
+    unsigned int echo = trigger();
+    if (echo == NO_ECHO) {
+        delayMicroseconds(_maxEchoTime);
+        return NO_ECHO;
+    }
+    delayMicroseconds(echo);
+    return echo;
+}
+
+unsigned long NewPing::ping_cm(unsigned int max_cm_distance) {
+    return ping(max_cm_distance) / US_ROUNDTRIP_CM;
+}
+
+unsigned long NewPing::ping_in(unsigned int max_cm_distance) {
+    return ping(max_cm_distance) / US_ROUNDTRIP_IN;
+}
+
+unsigned long NewPing::ping_median(uint8_t it, unsigned int max_cm_distance) {
+    unsigned int uS[it], last;
+    uint8_t j, i = 0;
+    uint32_t t;
+    uS[0] = NO_ECHO;
+
+    while (i < it) {
+        t = micros();
+        last = ping(max_cm_distance);
+
+        if (last != NO_ECHO) {
+            if (i > 0) {
+                for (j = i; j > 0 && uS[j - 1] < last; j--) {
+                    uS[j] = uS[j - 1];
+                }
+            } else {
+                j = 0;
+            }
+            uS[j] = last;
+            i++;
+        } else {
+            it--;
+        }
+
+        if (i < it && micros() - t < PING_MEDIAN_DELAY) {
+            delay((PING_MEDIAN_DELAY + t - micros()) / 1000);
+        }
+    }
+    return (uS[it >> 1]);
+}
+
+unsigned int NewPing::convert_cm(unsigned int echoTime) {
+    return echoTime / US_ROUNDTRIP_CM;
+}
+
+unsigned int NewPing::convert_in(unsigned int echoTime) {
+    return echoTime / US_ROUNDTRIP_IN;
+}
+
+void NewPing::ping_timer(void (*userFunc)(void), unsigned int max_cm_distance) {
+    if (max_cm_distance > 0) {
+        set_max_distance(max_cm_distance);
+    }
+    _echo = trigger();
+    _echoStartUs = nativeMicros();
+    _maxTimeUs = _echoStartUs + _maxEchoTime;
+    timer_us(ECHO_TIMER_FREQ, userFunc);
+}
+
+boolean NewPing::check_timer() {
+    unsigned long long now = nativeMicros();
+    if (now > _maxTimeUs) {
+        timer_stop();
+        return false;
+    }
+    if (_echo != NO_ECHO && now >= _echoStartUs + _echo) {
+        timer_stop();
+        ping_result = _echo;
+        return true;
+    }
+    return false;
+}
+
+void NewPing::timer_us(unsigned int frequency, void (*userFunc)(void)) {
+    pingTimer.start(frequency * 1000ULL, userFunc);
+}
+
+void NewPing::timer_ms(unsigned long frequency, void (*userFunc)(void)) {
+    pingTimer.start(frequency * 1000000ULL, userFunc);
+}
+
+void NewPing::timer_stop() {
+    pingTimer.stop();
+}
@@ -0,0 +1,60 @@
+/**
+    Reemplazo de NewPing para el host nativo.
+    Mantiene la API de la biblioteca original (incluido el modo timer) pero el eco
+    lo provee un modelo: un tiempo fijo (nativeSetEchoTime()) o una función del tiempo
+    (nativeSetEchoSource()). Las llamadas bloqueantes avanzan el reloj virtual lo mismo
+    que tardaría el sensor real; el modo timer dispara userFunc cada ECHO_TIMER_FREQ us.
+    @file NewPing.h
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+#ifndef NewPing_h
+#define NewPing_h
+
+#include "Arduino.h"
+
+#define MAX_SENSOR_DISTANCE 500
+#define US_ROUNDTRIP_CM 57
+#define US_ROUNDTRIP_IN 146
+#define TIMER_ENABLED true
+#define NO_ECHO 0
+#define MAX_SENSOR_DELAY 5800
+#define ECHO_TIMER_FREQ 24
+#define PING_MEDIAN_DELAY 29000
+#define PING_OVERHEAD 1
+#define PING_TIMER_OVERHEAD 1
+
+#define NATIVE_PING_START_DELAY 450 // Demora típica del HC-SR04 entre el trigger y el inicio del eco (en us).
+
+typedef unsigned int (*NativeEchoSource)(unsigned long long us);
+void nativeSetEchoTime(unsigned int us);
+void nativeSetEchoSource(NativeEchoSource source);
+
+class NewPing {
+public:
+    NewPing(uint8_t trigger_pin, uint8_t echo_pin, unsigned int max_cm_distance = MAX_SENSOR_DISTANCE);
+    unsigned int ping(unsigned int max_cm_distance = 0);
+    unsigned long ping_cm(unsigned int max_cm_distance = 0);
+    unsigned long ping_in(unsigned int max_cm_distance = 0);
+    unsigned long ping_median(uint8_t it = 5, unsigned int max_cm_distance = 0);
+    static unsigned int convert_cm(unsigned int echoTime);
+    static unsigned int convert_in(unsigned int echoTime);
+    void ping_timer(void (*userFunc)(void), unsigned int max_cm_distance = 0);
+    boolean check_timer();
+    unsigned long ping_result;
+    static void timer_us(unsigned int frequency, void (*userFunc)(void));
+    static void timer_ms(unsigned long frequency, void (*userFunc)(void));
+    static void timer_stop();
+
+private:
+    void set_max_distance(unsigned int max_cm_distance);
+    unsigned int trigger();
+    unsigned int _maxEchoTime;
+    unsigned long long _echoStartUs;
+    unsigned long long _maxTimeUs;
+    unsigned int _echo;
+};
+
+#endif
@@ -0,0 +1,58 @@
+/**
+    Reemplazo de la clase Print de Arduino para el host nativo.
+    @file Print.h
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+#ifndef Print_h
+#define Print_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "WString.h"
+
+class Print {
+public:
+    Print() {}
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    size_t write(const char *str);
+    size_t write(const char *buffer, size_t size) { return write((const uint8_t *)buffer, size); }
+
+    size_t print(const __FlashStringHelper *);
+    size_t print(const String &);
+    size_t print(const char[]);
+    size_t print(char);
+    size_t print(unsigned char, int = DEC_BASE);
+    size_t print(int, int = DEC_BASE);
+    size_t print(unsigned int, int = DEC_BASE);
+    size_t print(long, int = DEC_BASE);
+    size_t print(unsigned long, int = DEC_BASE);
+    size_t print(double, int = 2);
+
+    size_t println(const __FlashStringHelper *);
+    size_t println(const String &s);
+    size_t println(const char[]);
+    size_t println(char);
+    size_t println(unsigned char, int = DEC_BASE);
+    size_t println(int, int = DEC_BASE);
+    size_t println(unsigned int, int = DEC_BASE);
+    size_t println(long, int = DEC_BASE);
+    size_t println(unsigned long, int = DEC_BASE);
+    size_t println(double, int = 2);
+    size_t println(void);
+
+    virtual void flush() {}
+
+private:
+    enum { DEC_BASE = 10 };
+    size_t printNumber(unsigned long, uint8_t);
+    size_t printFloat(double, uint8_t);
+};
+
+#endif
@@ -0,0 +1,35 @@
+/**
+    Implementación del bus SPI para el host nativo.
+    @file SPI.cpp
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+#include "SPI.h"
+#include "NativeHardware.h"
+#include "NativeSX1278.h"
+
+SPIClass SPI;
+
+void SPIClass::beginTransaction(SPISettings settings) {
+    (void)settings;
+    SX1278.select();
+}
+
+uint8_t SPIClass::transfer(uint8_t data) {
+    nativeAdvance(NATIVE_COST_SPI_BYTE_NS);
+    return SX1278.transfer(data);
+}
+
+void SPIClass::transfer(void *buf, size_t count) {
+    uint8_t *p = (uint8_t *)buf;
+    for (size_t i = 0; i < count; i++) {
+        p[i] = transfer(p[i]);
+    }
+}
+
+void SPIClass::endTransaction(void) {
+    SX1278.deselect();
+    nativeAdvance(NATIVE_COST_SPI_TRANSACTION_NS);
+}
@@ -0,0 +1,47 @@
+/**
+    Reemplazo de la biblioteca SPI para el host nativo.
+    Cada transacción (beginTransaction() ... endTransaction()) se entrega al
+    modelo de registros del SX1278 (ver NativeSX1278.h), que es el único esclavo del bus.
+    @file SPI.h
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+#ifndef _SPI_H_INCLUDED
+#define _SPI_H_INCLUDED
+
+#include "Arduino.h"
+
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x04
+#define SPI_MODE2 0x08
+#define SPI_MODE3 0x0C
+
+/// Costos aproximados (en ns) del SPI por hardware de un ATmega328 a 16 MHz y 8 MHz de reloj SPI.
+#define NATIVE_COST_SPI_TRANSACTION_NS 1000UL // beginTransaction() + endTransaction().
+#define NATIVE_COST_SPI_BYTE_NS 1500UL        // transfer() de un byte (8 bits + espera de SPIF).
+
+class SPISettings {
+public:
+    SPISettings() : clock(4000000), bitOrder(MSBFIRST), dataMode(SPI_MODE0) {}
+    SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode)
+        : clock(clock), bitOrder(bitOrder), dataMode(dataMode) {}
+    uint32_t clock;
+    uint8_t bitOrder;
+    uint8_t dataMode;
+};
+
+class SPIClass {
+public:
+    static void begin() {}
+    static void end() {}
+    static void beginTransaction(SPISettings settings);
+    static uint8_t transfer(uint8_t data);
+    static void transfer(void *buf, size_t count);
+    static void endTransaction(void);
+};
+
+extern SPIClass SPI;
+
+#endif
@@ -0,0 +1,102 @@
+/**
+    Implementación de SoftwareSerial para el host nativo.
+    @file SoftwareSerial.cpp
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+#include "SoftwareSerial.h"
+#include "NativeHardware.h"
+
+SoftwareSerial::SoftwareSerial(uint8_t receivePin, uint8_t transmitPin, bool inverse_logic) {
+    (void)receivePin;
+    (void)transmitPin;
+    (void)inverse_logic;
+    _byteTimeNs = 10000000000UL / 9600;
+    _lastArrivalNs = 0;
+    _overflow = false;
+    _overflowCount = 0;
+    _rxHead = _rxTail = 0;
+    _pendingFirstArrivalNs = 0;
+    _pendingHead = 0;
+    _pendingCount = 0;
+}
+
+void SoftwareSerial::begin(long speed) {
+    // 10 bits por byte (start + 8 datos + stop).
+    _byteTimeNs = 10000000000UL / (unsigned long)speed;
+}
+
+/**
+    feed() pone bytes "en el cable": el primero termina de llegar un tiempo de byte
+    después del último pendiente (o de ahora, si no hay ninguno).
+    @return Cantidad de bytes aceptados.
+*/
+size_t SoftwareSerial::feed(const char *data, size_t length) {
+    receiveArrived();
+    if (_pendingCount == 0) {
+        unsigned long long now = nativeNanos();
+        _pendingFirstArrivalNs = (_lastArrivalNs > now ? _lastArrivalNs : now) + _byteTimeNs;
+    }
+    size_t accepted = 0;
+    while (accepted < length && _pendingCount < NATIVE_SS_MAX_PENDING) {
+        _pending[(_pendingHead + _pendingCount) % NATIVE_SS_MAX_PENDING] = data[accepted++];
+        _pendingCount++;
+    }
+    return accepted;
+}
+
+/**
+    receiveArrived() mueve al buffer de recepción los bytes cuyo tiempo de llegada ya pasó,
+    descartando los que no entran (como haría la ISR de SoftwareSerial).
+*/
+void SoftwareSerial::receiveArrived() {
+    unsigned long long now = nativeNanos();
+    while (_pendingCount > 0 && _pendingFirstArrivalNs <= now) {
+        char c = _pending[_pendingHead];
+        _pendingHead = (_pendingHead + 1) % NATIVE_SS_MAX_PENDING;
+        _pendingCount--;
+        _lastArrivalNs = _pendingFirstArrivalNs;
+        _pendingFirstArrivalNs += _byteTimeNs;
+
+        uint8_t next = (_rxTail + 1) % _SS_MAX_RX_BUFF;
+        if (next != _rxHead) {
+            _rx[_rxTail] = c;
+            _rxTail = next;
+        } else {
+            _overflow = true;
+            _overflowCount++;
+        }
+    }
+}
+
+int SoftwareSerial::available() {
+    receiveArrived();
+    return (_rxTail + _SS_MAX_RX_BUFF - _rxHead) % _SS_MAX_RX_BUFF;
+}
+
+int SoftwareSerial::read() {
+    receiveArrived();
+    if (_rxHead == _rxTail) {
+        return -1;
+    }
+    uint8_t d = _rx[_rxHead];
+    _rxHead = (_rxHead + 1) % _SS_MAX_RX_BUFF;
+    return d;
+}
+
+int SoftwareSerial::peek() {
+    receiveArrived();
+    if (_rxHead == _rxTail) {
+        return -1;
+    }
+    return (uint8_t)_rx[_rxHead];
+}
+
+size_t SoftwareSerial::write(uint8_t byte) {
+    (void)byte;
+    // La transmisión por software bloquea durante todo el byte.
+    nativeAdvance(_byteTimeNs);
+    return 1;
+}
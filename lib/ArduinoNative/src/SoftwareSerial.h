@@ -0,0 +1,59 @@
+/**
+    Reemplazo de SoftwareSerial para el host nativo.
+    Los bytes que se entregan con feed() "llegan" al ritmo del bitrate configurado
+    y se encolan en un buffer de _SS_MAX_RX_BUFF bytes, igual que en el AVR:
+    si el programa no los lee a tiempo, se pierden (ver overflowCount()).
+    @file SoftwareSerial.h
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+#ifndef SoftwareSerial_h
+#define SoftwareSerial_h
+
+#include "Arduino.h"
+
+#define _SS_MAX_RX_BUFF 64
+#define NATIVE_SS_MAX_PENDING 4096 // Bytes "en el cable" que aún no llegaron.
+
+class SoftwareSerial : public Stream {
+public:
+    SoftwareSerial(uint8_t receivePin, uint8_t transmitPin, bool inverse_logic = false);
+
+    void begin(long speed);
+    void end() {}
+    bool listen() { return true; }
+    bool isListening() { return true; }
+    bool overflow() { bool ret = _overflow; _overflow = false; return ret; }
+
+    virtual int available();
+    virtual int read();
+    virtual int peek();
+    virtual size_t write(uint8_t byte);
+    using Print::write;
+
+    // Lado "cable".
+    size_t feed(const char *data, size_t length);
+    unsigned long overflowCount() const { return _overflowCount; }
+    size_t pending() const { return _pendingCount; }
+
+private:
+    unsigned long _byteTimeNs;
+    unsigned long long _lastArrivalNs;
+    bool _overflow;
+    unsigned long _overflowCount;
+
+    char _rx[_SS_MAX_RX_BUFF];
+    uint8_t _rxHead;
+    uint8_t _rxTail;
+
+    char _pending[NATIVE_SS_MAX_PENDING];
+    unsigned long long _pendingFirstArrivalNs;
+    size_t _pendingHead;
+    size_t _pendingCount;
+
+    void receiveArrived();
+};
+
+#endif
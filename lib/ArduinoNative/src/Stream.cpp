@@ -0,0 +1,34 @@
+/**
+    Implementación de la clase Stream para el host nativo.
+    @file Stream.cpp
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+#include "Arduino.h"
+
+int Stream::timedRead() {
+    uint32_t startMillis = millis();
+    do {
+        int c = read();
+        if (c >= 0) {
+            return c;
+        }
+        yield();
+    } while (millis() - startMillis < _timeout);
+    return -1;
+}
+
+size_t Stream::readBytes(char *buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+        int c = timedRead();
+        if (c < 0) {
+            break;
+        }
+        *buffer++ = (char)c;
+        count++;
+    }
+    return count;
+}
@@ -0,0 +1,33 @@
+/**
+    Reemplazo de la clase Stream de Arduino para el host nativo.
+    @file Stream.h
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+#ifndef Stream_h
+#define Stream_h
+
+#include "Print.h"
+
+class Stream : public Print {
+public:
+    Stream() : _timeout(1000) {}
+
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long timeout) { _timeout = timeout; }
+    unsigned long getTimeout(void) { return _timeout; }
+
+    size_t readBytes(char *buffer, size_t length);
+    size_t readBytes(uint8_t *buffer, size_t length) { return readBytes((char *)buffer, length); }
+
+protected:
+    unsigned long _timeout;
+    int timedRead();
+};
+
+#endif
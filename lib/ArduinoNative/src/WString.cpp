@@ -0,0 +1,275 @@
+/**
+    Implementación de la clase String para el host nativo.
+    @file WString.cpp
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+#include "Arduino.h"
+
+#include <stdio.h>
+
+String::String(const char *cstr) {
+    buffer = NULL;
+    capacity = 0;
+    len = 0;
+    if (cstr) {
+        copy(cstr, strlen(cstr));
+    }
+}
+
+String::String(const String &value) {
+    buffer = NULL;
+    capacity = 0;
+    len = 0;
+    *this = value;
+}
+
+String::String(String &&rval) {
+    buffer = rval.buffer;
+    capacity = rval.capacity;
+    len = rval.len;
+    rval.buffer = NULL;
+    rval.capacity = 0;
+    rval.len = 0;
+}
+
+String::String(char c) : String() {
+    char buf[2] = {c, 0};
+    *this = buf;
+}
+
+String::String(unsigned char value, unsigned char base) : String((unsigned long)value, base) {}
+
+String::String(int value, unsigned char base) : String((long)value, base) {}
+
+String::String(unsigned int value, unsigned char base) : String((unsigned long)value, base) {}
+
+String::String(long value, unsigned char base) : String() {
+    char buf[2 + 8 * sizeof(long)];
+    if (base == 10) {
+        snprintf(buf, sizeof(buf), "%ld", value);
+    } else {
+        snprintf(buf, sizeof(buf), base == 16 ? "%lx" : "%lo", value);
+    }
+    *this = buf;
+}
+
+String::String(unsigned long value, unsigned char base) : String() {
+    char buf[1 + 8 * sizeof(unsigned long)];
+    snprintf(buf, sizeof(buf), base == 16 ? "%lx" : (base == 8 ? "%lo" : "%lu"), value);
+    *this = buf;
+}
+
+String::String(float value, unsigned char decimalPlaces) : String((double)value, decimalPlaces) {}
+
+String::String(double value, unsigned char decimalPlaces) : String() {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.*f", decimalPlaces, value);
+    *this = buf;
+}
+
+String::~String() {
+    free(buffer);
+}
+
+void String::invalidate() {
+    free(buffer);
+    buffer = NULL;
+    capacity = len = 0;
+}
+
+unsigned char String::reserve(unsigned int size) {
+    if (buffer && capacity >= size) {
+        return 1;
+    }
+    if (changeBuffer(size)) {
+        if (len == 0) {
+            buffer[0] = 0;
+        }
+        return 1;
+    }
+    return 0;
+}
+
+unsigned char String::changeBuffer(unsigned int maxStrLen) {
+    char *newbuffer = (char *)realloc(buffer, maxStrLen + 1);
+    if (newbuffer) {
+        buffer = newbuffer;
+        capacity = maxStrLen;
+        return 1;
+    }
+    return 0;
+}
+
+String &String::copy(const char *cstr, unsigned int length) {
+    if (!reserve(length)) {
+        invalidate();
+        return *this;
+    }
+    len = length;
+    memmove(buffer, cstr, length);
+    buffer[len] = 0;
+    return *this;
+}
+
+String &String::operator = (const String &rhs) {
+    if (this == &rhs) {
+        return *this;
+    }
+    if (rhs.buffer) {
+        copy(rhs.buffer, rhs.len);
+    } else {
+        invalidate();
+    }
+    return *this;
+}
+
+String &String::operator = (const char *cstr) {
+    if (cstr) {
+        copy(cstr, strlen(cstr));
+    } else {
+        invalidate();
+    }
+    return *this;
+}
+
+String &String::operator = (String &&rval) {
+    if (this != &rval) {
+        free(buffer);
+        buffer = rval.buffer;
+        capacity = rval.capacity;
+        len = rval.len;
+        rval.buffer = NULL;
+        rval.capacity = 0;
+        rval.len = 0;
+    }
+    return *this;
+}
+
+unsigned char String::concat(const char *cstr, unsigned int length) {
+    unsigned int newlen = len + length;
+    if (!cstr) {
+        return 0;
+    }
+    if (length == 0) {
+        return 1;
+    }
+    if (!reserve(newlen)) {
+        return 0;
+    }
+    memmove(buffer + len, cstr, length);
+    len = newlen;
+    buffer[len] = 0;
+    return 1;
+}
+
+unsigned char String::concat(const String &s) {
+    return concat(s.buffer, s.len);
+}
+
+unsigned char String::concat(const char *cstr) {
+    if (!cstr) {
+        return 0;
+    }
+    return concat(cstr, strlen(cstr));
+}
+
+unsigned char String::concat(char c) {
+    char buf[2] = {c, 0};
+    return concat(buf, 1);
+}
+
+unsigned char String::concat(unsigned char num) { return concat(String(num)); }
+unsigned char String::concat(int num) { return concat(String(num)); }
+unsigned char String::concat(unsigned int num) { return concat(String(num)); }
+unsigned char String::concat(long num) { return concat(String(num)); }
+unsigned char String::concat(unsigned long num) { return concat(String(num)); }
+unsigned char String::concat(float num) { return concat(String(num)); }
+unsigned char String::concat(double num) { return concat(String(num)); }
+
+unsigned char String::equals(const String &s2) const {
+    return (len == s2.len && strcmp(c_str() ? c_str() : "", s2.c_str() ? s2.c_str() : "") == 0);
+}
+
+unsigned char String::equals(const char *cstr) const {
+    if (len == 0) {
+        return (cstr == NULL || *cstr == 0);
+    }
+    if (cstr == NULL) {
+        return buffer[0] == 0;
+    }
+    return strcmp(buffer, cstr) == 0;
+}
+
+char String::charAt(unsigned int loc) const {
+    return operator[](loc);
+}
+
+char String::operator [] (unsigned int index) const {
+    if (index >= len || !buffer) {
+        return 0;
+    }
+    return buffer[index];
+}
+
+int String::indexOf(char ch, unsigned int fromIndex) const {
+    if (fromIndex >= len) {
+        return -1;
+    }
+    const char *temp = strchr(buffer + fromIndex, ch);
+    if (temp == NULL) {
+        return -1;
+    }
+    return temp - buffer;
+}
+
+unsigned char String::startsWith(const String &prefix) const {
+    if (len < prefix.len) {
+        return 0;
+    }
+    return prefix.len == 0 || strncmp(buffer, prefix.buffer, prefix.len) == 0;
+}
+
+int String::indexOf(const String &s2, unsigned int fromIndex) const {
+    if (fromIndex >= len) {
+        return -1;
+    }
+    const char *found = strstr(buffer + fromIndex, s2.buffer ? s2.buffer : "");
+    if (found == NULL) {
+        return -1;
+    }
+    return found - buffer;
+}
+
+String String::substring(unsigned int left, unsigned int right) const {
+    if (left > right) {
+        unsigned int temp = right;
+        right = left;
+        left = temp;
+    }
+    String out;
+    if (left >= len) {
+        return out;
+    }
+    if (right > len) {
+        right = len;
+    }
+    out.copy(buffer + left, right - left);
+    return out;
+}
+
+long String::toInt() const {
+    if (buffer) {
+        return atol(buffer);
+    }
+    return 0;
+}
+
+float String::toFloat() const {
+    if (buffer) {
+        return (float)atof(buffer);
+    }
+    return 0;
+}
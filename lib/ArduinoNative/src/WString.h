@@ -0,0 +1,87 @@
+/**
+    Reemplazo de la clase String de Arduino para el host nativo.
+    Respeta la semántica de reserve() y del crecimiento en heap del core AVR
+    para que los perfiles de memoria del host sean comparables.
+    @file WString.h
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+#ifndef String_class_h
+#define String_class_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+class __FlashStringHelper;
+
+class String {
+public:
+    String(const char *cstr = "");
+    String(const String &str);
+    String(String &&rval);
+    explicit String(char c);
+    explicit String(unsigned char value, unsigned char base = 10);
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(float value, unsigned char decimalPlaces = 2);
+    explicit String(double value, unsigned char decimalPlaces = 2);
+    ~String();
+
+    unsigned char reserve(unsigned int size);
+    unsigned int length() const { return len; }
+
+    String &operator = (const String &rhs);
+    String &operator = (const char *cstr);
+    String &operator = (String &&rval);
+
+    unsigned char concat(const String &str);
+    unsigned char concat(const char *cstr);
+    unsigned char concat(const char *cstr, unsigned int length);
+    unsigned char concat(char c);
+    unsigned char concat(unsigned char num);
+    unsigned char concat(int num);
+    unsigned char concat(unsigned int num);
+    unsigned char concat(long num);
+    unsigned char concat(unsigned long num);
+    unsigned char concat(float num);
+    unsigned char concat(double num);
+
+    template <typename T>
+    String &operator += (T rhs) { concat(rhs); return *this; }
+
+    unsigned char equals(const String &s) const;
+    unsigned char equals(const char *cstr) const;
+    unsigned char operator == (const String &rhs) const { return equals(rhs); }
+    unsigned char operator == (const char *cstr) const { return equals(cstr); }
+    unsigned char operator != (const String &rhs) const { return !equals(rhs); }
+    unsigned char operator != (const char *cstr) const { return !equals(cstr); }
+
+    unsigned char startsWith(const String &prefix) const;
+
+    char charAt(unsigned int index) const;
+    char operator [] (unsigned int index) const;
+    const char *c_str() const { return buffer; }
+
+    int indexOf(char ch, unsigned int fromIndex = 0) const;
+    int indexOf(const String &str, unsigned int fromIndex = 0) const;
+    String substring(unsigned int beginIndex) const { return substring(beginIndex, len); }
+    String substring(unsigned int beginIndex, unsigned int endIndex) const;
+
+    long toInt() const;
+    float toFloat() const;
+
+private:
+    char *buffer;
+    unsigned int capacity;
+    unsigned int len;
+
+    void invalidate();
+    unsigned char changeBuffer(unsigned int maxStrLen);
+    String &copy(const char *cstr, unsigned int length);
+};
+
+#endif
@@ -0,0 +1,14 @@
+/**
+    Reemplazo de <avr/pgmspace.h> para el host nativo (la memoria de programa es la misma RAM).
+    @file pgmspace.h
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+#ifndef __PGMSPACE_H_
+#define __PGMSPACE_H_
+
+#include "../Arduino.h"
+
+#endif
@@ -0,0 +1,34 @@
+/**
+    Reemplazo de <avr/wdt.h> para el host nativo.
+    El watchdog se modela sobre el reloj virtual: si vence, el proceso termina con código 2.
+    @file wdt.h
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+#ifndef _AVR_WDT_H_
+#define _AVR_WDT_H_
+
+#include "../NativeHardware.h"
+
+#define WDTO_15MS 0
+#define WDTO_30MS 1
+#define WDTO_60MS 2
+#define WDTO_120MS 3
+#define WDTO_250MS 4
+#define WDTO_500MS 5
+#define WDTO_1S 6
+#define WDTO_2S 7
+#define WDTO_4S 8
+#define WDTO_8S 9
+
+static inline void wdt_enable(uint8_t value) {
+    static const unsigned long timeouts[] = {15, 30, 60, 120, 250, 500, 1000, 2000, 4000, 8000};
+    nativeWatchdogEnable(timeouts[value < 10 ? value : 9]);
+}
+
+#define wdt_reset() nativeWatchdogReset()
+#define wdt_disable() nativeWatchdogDisable()
+
+#endif
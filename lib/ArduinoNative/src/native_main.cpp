@@ -0,0 +1,44 @@
+/**
+    Punto de entrada del firmware en el host nativo: llama a setup() y luego a loop()
+    hasta cumplir la cantidad de segundos virtuales pedida (NATIVE_RUN_SECONDS o argv[1]).
+    Cada pasada de loop() suma NATIVE_LOOP_COST_NS al reloj virtual, además de lo que
+    cuesten las primitivas que llame.
+    Un arnés propio puede reemplazar este main definiendo NATIVE_CUSTOM_MAIN.
+    @file native_main.cpp
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+#ifndef NATIVE_CUSTOM_MAIN
+
+#include "Arduino.h"
+#include "NativeHardware.h"
+
+#include <stdio.h>
+
+#ifndef NATIVE_RUN_SECONDS
+#define NATIVE_RUN_SECONDS 60
+#endif
+
+#ifndef NATIVE_LOOP_COST_NS
+#define NATIVE_LOOP_COST_NS 20000ULL // Overhead propio de una pasada de loop() (en ns).
+#endif
+
+int main(int argc, char **argv) {
+    unsigned long long seconds = NATIVE_RUN_SECONDS;
+    if (argc > 1) {
+        seconds = strtoull(argv[1], NULL, 10);
+    }
+    unsigned long long end = seconds * 1000000000ULL;
+
+    setup();
+    while (nativeNanos() < end) {
+        loop();
+        nativeAdvance(NATIVE_LOOP_COST_NS);
+    }
+    fflush(stdout);
+    return 0;
+}
+
+#endif
@@ -19,6 +19,16 @@
 #endif
 
 
+//--------------------------------------------------------------------------------------
+EnergyMonitor::EnergyMonitor()
+{
+  stateVI = EMON_VI_IDLE;
+  reader = NULL;
+  vccReader = NULL;
+  vccValid = false;
+  vccInterval = EMON_VCC_REFRESH;
+}
+
 //--------------------------------------------------------------------------------------
 // Sets the pins to be used for voltage and current sensors
 //--------------------------------------------------------------------------------------
@@ -28,6 +38,11 @@ void EnergyMonitor::voltage(unsigned int _inPinV, double _VCAL, double _PHASECAL
   VCAL = _VCAL;
   PHASECAL = _PHASECAL;
   offsetV = ADC_COUNTS>>1;
+  #if EMON_FIXED_POINT
+  offsetV <<= EMON_OFFSET_BITS;
+  phasecal = PHASECAL * (1 << EMON_PHASECAL_BITS) + 0.5;
+  #endif
+  stateVI = EMON_VI_IDLE;
 }
 
 void EnergyMonitor::current(unsigned int _inPinI, double _ICAL)
@@ -35,6 +50,10 @@ void EnergyMonitor::current(unsigned int _inPinI, double _ICAL)
   inPinI = _inPinI;
   ICAL = _ICAL;
   offsetI = ADC_COUNTS>>1;
+  #if EMON_FIXED_POINT
+  offsetI <<= EMON_OFFSET_BITS;
+  #endif
+  stateVI = EMON_VI_IDLE;
 }
 
 //--------------------------------------------------------------------------------------
@@ -46,6 +65,10 @@ void EnergyMonitor::voltageTX(double _VCAL, double _PHASECAL)
   VCAL = _VCAL;
   PHASECAL = _PHASECAL;
   offsetV = ADC_COUNTS>>1;
+  #if EMON_FIXED_POINT
+  offsetV <<= EMON_OFFSET_BITS;
+  phasecal = PHASECAL * (1 << EMON_PHASECAL_BITS) + 0.5;
+  #endif
 }
 
 void EnergyMonitor::currentTX(unsigned int _channel, double _ICAL)
@@ -55,6 +78,9 @@ void EnergyMonitor::currentTX(unsigned int _channel, double _ICAL)
   if (_channel == 3) inPinI = 1;
   ICAL = _ICAL;
   offsetI = ADC_COUNTS>>1;
+  #if EMON_FIXED_POINT
+  offsetI <<= EMON_OFFSET_BITS;
+  #endif
 }
 
 //--------------------------------------------------------------------------------------
@@ -62,105 +88,415 @@ void EnergyMonitor::currentTX(unsigned int _channel, double _ICAL)
 // Calculates realPower,apparentPower,powerFactor,Vrms,Irms,kWh increment
 // From a sample window of the mains AC voltage and current.
 // The Sample window length is defined by the number of half wavelengths or crossings we choose to measure.
+// Blocking wrapper around beginVI() / pollVI().
 //--------------------------------------------------------------------------------------
 void EnergyMonitor::calcVI(unsigned int crossings, unsigned int timeout)
+{
+  beginVI(crossings, timeout);
+  while (!pollVI(1)) yield();
+  stateVI = EMON_VI_IDLE;
+}
+
+//--------------------------------------------------------------------------------------
+// Starts a non-blocking calcVI(): pollVI() must then be called until it returns true.
+//--------------------------------------------------------------------------------------
+void EnergyMonitor::beginVI(unsigned int crossings, unsigned int timeout)
 {
   #if defined emonTxV3
-  int SupplyVoltage=3300;
+  SupplyVoltage=3300;
   #else
-  int SupplyVoltage = readVcc();
+  SupplyVoltage = supplyVoltage();
   #endif
 
-  unsigned int crossCount = 0;                             //Used to measure number of times threshold is crossed.
-  unsigned int numberOfSamples = 0;                        //This is now incremented
+  crossingsVI = crossings;
+  timeoutVI = timeout;
+  crossCount = 0;                                          //Used to measure number of times threshold is crossed.
+  numberOfSamples = 0;                                     //This is now incremented
+  sumV = 0;
+  sumI = 0;
+  sumP = 0;
+  pendingV = false;
+
+  startVI = millis();    //millis()-startVI makes sure it doesnt get stuck in the loop if there is an error.
+  stateVI = EMON_VI_WAITING;
+  voltageVI = true;
+}
 
-  //-------------------------------------------------------------------------------------------------------------------------
-  // 1) Waits for the waveform to be close to 'zero' (mid-scale adc) part in sin curve.
-  //-------------------------------------------------------------------------------------------------------------------------
-  unsigned long start = millis();    //millis()-start makes sure it doesnt get stuck in the loop if there is an error.
+//--------------------------------------------------------------------------------------
+// Current-only calcVI(): samples just the CT channel, so there are half as many
+// conversions per sample and the voltage input does not need to be connected.
+// The window starts and ends on a crossing of the current waveform (with
+// EMON_I_HYSTERESIS counts of hysteresis), so it spans whole half wavelengths.
+// If the current is too small to cross, the samples taken while waiting for the
+// first crossing are used instead, so the whole measurement lasts one timeout.
+//--------------------------------------------------------------------------------------
+void EnergyMonitor::calcI(unsigned int crossings, unsigned int timeout)
+{
+  beginI(crossings, timeout);
+  while (!pollVI(1)) yield();
+  stateVI = EMON_VI_IDLE;
+}
 
-  while(1)                                   //the while loop...
+void EnergyMonitor::beginI(unsigned int crossings, unsigned int timeout)
+{
+  beginVI(crossings, timeout);
+  voltageVI = false;
+  polarityI = 0;
+}
+
+//--------------------------------------------------------------------------------------
+// Advances the measurement started by beginVI() by at most maxSamples samples
+// (each one is an analogRead() pair, or a single one while waiting for mid-scale).
+// Never waits for the sample reader: it returns early when no sample is available,
+// and the timeout is checked before each sample, so it also ends if none ever arrives.
+// Returns true once the results (Vrms, Irms, ...) are available.
+//--------------------------------------------------------------------------------------
+boolean EnergyMonitor::pollVI(unsigned int maxSamples)
+{
+  for (unsigned int n = 0; n < maxSamples; n++)
   {
-    startV = analogRead(inPinV);                    //using the voltage waveform
-    if ((startV < (ADC_COUNTS*0.55)) && (startV > (ADC_COUNTS*0.45))) break;  //check its within range
-    if ((millis()-start)>timeout) break;
+    if (stateVI == EMON_VI_WAITING)
+    {
+      //-------------------------------------------------------------------------------------------------------------------------
+      // 1) Waits for the waveform to be close to 'zero' (mid-scale adc) part in sin curve.
+      //-------------------------------------------------------------------------------------------------------------------------
+      if (voltageVI)
+      {
+        if ((millis()-startVI)>timeoutVI)               //using the voltage waveform
+        {
+          startVI = millis();
+          stateVI = EMON_VI_SAMPLING;
+        }
+        else if (!readSample(inPinV, startV))
+        {
+          break;                                        //no sample available yet
+        }
+        else if ((startV < (ADC_COUNTS*0.55)) && (startV > (ADC_COUNTS*0.45)))
+        {
+          startVI = millis();
+          stateVI = EMON_VI_SAMPLING;
+        }
+      }
+      else if ((millis()-startVI)>timeoutVI)            //using the current waveform
+      {
+        finishVI();                                     //too small to cross: rms of the whole wait
+        stateVI = EMON_VI_READY;
+        break;
+      }
+      else if (!readI())
+      {
+        break;                                          //no sample available yet
+      }
+      else if (accumulateI())
+      {
+        numberOfSamples = 0;                            //the window starts on this crossing
+        sumI = 0;
+        startVI = millis();
+        stateVI = EMON_VI_SAMPLING;
+      }
+    }
+    else if (stateVI == EMON_VI_SAMPLING)
+    {
+      //-------------------------------------------------------------------------------------------------------------------------
+      // 2) Main measurement loop
+      //-------------------------------------------------------------------------------------------------------------------------
+      if ((crossCount >= crossingsVI) || ((millis()-startVI)>=timeoutVI))
+      {
+        finishVI();
+        stateVI = EMON_VI_READY;
+        break;
+      }
+      if (voltageVI)
+      {
+        if (!readVI()) break;                           //no sample pair available yet
+        sampleVI();
+      }
+      else if (!readI())
+      {
+        break;                                          //no sample available yet
+      }
+      else if (accumulateI())
+      {
+        crossCount++;
+      }
+    }
+    else break;
   }
 
-  //-------------------------------------------------------------------------------------------------------------------------
-  // 2) Main measurement loop
-  //-------------------------------------------------------------------------------------------------------------------------
-  start = millis();
+  return stateVI == EMON_VI_READY;
+}
+
+//--------------------------------------------------------------------------------------
+// Sets the sample and supply voltage sources (NULL: analogRead() and readVcc()).
+// pollVI() stops early when reader has no sample available, so beginVI() and beginI()
+// measurements never wait for the ADC; calcVI(), calcI() and calcIrms() wait for it,
+// but calcIrms() falls back to analogRead() if reader has none for EMON_SAMPLE_TIMEOUT ms
+// (e.g. it does not sample that pin), and the others end on their timeout.
+//--------------------------------------------------------------------------------------
+void EnergyMonitor::sampleReader(EmonSampleReader _reader, EmonVccReader _vccReader)
+{
+  reader = _reader;
+  vccReader = _vccReader;
+}
 
-  while ((crossCount < crossings) && ((millis()-start)<timeout))
+boolean EnergyMonitor::readSample(unsigned int pin, int &sample)
+{
+  if (reader) return reader(pin, sample);
+  sample = analogRead(pin);
+  return true;
+}
+
+void EnergyMonitor::waitSample(unsigned int pin, int &sample)
+{
+  uint32_t start = millis();
+  while (!readSample(pin, sample))
   {
-    numberOfSamples++;                       //Count number of times looped.
-    lastFilteredV = filteredV;               //Used for delay/phase compensation
-
-    //-----------------------------------------------------------------------------
-    // A) Read in raw voltage and current samples
-    //-----------------------------------------------------------------------------
-    sampleV = analogRead(inPinV);                 //Read in raw voltage signal
-    sampleI = analogRead(inPinI);                 //Read in raw current signal
-
-    //-----------------------------------------------------------------------------
-    // B) Apply digital low pass filters to extract the 2.5 V or 1.65 V dc offset,
-    //     then subtract this - signal is now centred on 0 counts.
-    //-----------------------------------------------------------------------------
-    offsetV = offsetV + ((sampleV-offsetV)/1024);
-    filteredV = sampleV - offsetV;
-    offsetI = offsetI + ((sampleI-offsetI)/1024);
-    filteredI = sampleI - offsetI;
-
-    //-----------------------------------------------------------------------------
-    // C) Root-mean-square method voltage
-    //-----------------------------------------------------------------------------
-    sqV= filteredV * filteredV;                 //1) square voltage values
-    sumV += sqV;                                //2) sum
-
-    //-----------------------------------------------------------------------------
-    // D) Root-mean-square method current
-    //-----------------------------------------------------------------------------
-    sqI = filteredI * filteredI;                //1) square current values
-    sumI += sqI;                                //2) sum
-
-    //-----------------------------------------------------------------------------
-    // E) Phase calibration
-    //-----------------------------------------------------------------------------
-    phaseShiftedV = lastFilteredV + PHASECAL * (filteredV - lastFilteredV);
-
-    //-----------------------------------------------------------------------------
-    // F) Instantaneous power calc
-    //-----------------------------------------------------------------------------
-    instP = phaseShiftedV * filteredI;          //Instantaneous Power
-    sumP +=instP;                               //Sum
-
-    //-----------------------------------------------------------------------------
-    // G) Find the number of times the voltage has crossed the initial voltage
-    //    - every 2 crosses we will have sampled 1 wavelength
-    //    - so this method allows us to sample an integer number of half wavelengths which increases accuracy
-    //-----------------------------------------------------------------------------
-    lastVCross = checkVCross;
-    if (sampleV > startV) checkVCross = true;
-                     else checkVCross = false;
-    if (numberOfSamples==1) lastVCross = checkVCross;
-
-    if (lastVCross != checkVCross) crossCount++;
+    if ((millis()-start) >= EMON_SAMPLE_TIMEOUT)
+    {
+      sample = analogRead(pin);
+      return;
+    }
+    yield();
+  }
+}
+
+long EnergyMonitor::supplyVoltage()
+{
+  if (!vccValid || (millis() - vccMillis) >= vccInterval) refreshVcc();
+  return vcc;
+}
+
+//--------------------------------------------------------------------------------------
+// Supply voltage cache: refreshVcc() measures it now (through vccReader, if set),
+// cachedVcc() returns the last measurement (taking one if there is none yet) and
+// vccRefreshInterval() sets how old the cached value may get (0: always measure).
+//--------------------------------------------------------------------------------------
+long EnergyMonitor::cachedVcc()
+{
+  if (!vccValid) refreshVcc();
+  return vcc;
+}
+
+boolean EnergyMonitor::vccAvailable()
+{
+  return vccValid;
+}
+
+void EnergyMonitor::refreshVcc()
+{
+  vcc = vccReader ? vccReader() : readVcc();
+  vccMillis = millis();
+  vccValid = true;
+}
+
+void EnergyMonitor::vccRefreshInterval(unsigned long interval)
+{
+  vccInterval = interval;
+}
+
+//--------------------------------------------------------------------------------------
+// true while a measurement started by beginVI() is still in progress.
+//--------------------------------------------------------------------------------------
+boolean EnergyMonitor::measuring()
+{
+  return stateVI == EMON_VI_WAITING || stateVI == EMON_VI_SAMPLING;
+}
+
+//--------------------------------------------------------------------------------------
+// true once the measurement started by beginVI() has finished.
+//--------------------------------------------------------------------------------------
+boolean EnergyMonitor::ready()
+{
+  return stateVI == EMON_VI_READY;
+}
+
+//--------------------------------------------------------------------------------------
+// A) Reads a voltage/current sample pair. Returns false if the sample reader has
+//    none available yet; a voltage sample already read is kept for the next call.
+//--------------------------------------------------------------------------------------
+boolean EnergyMonitor::readVI()
+{
+  if (!pendingV)
+  {
+    if (!readSample(inPinV, sampleV)) return false;   //Read in raw voltage signal
+    pendingV = true;
+  }
+  if (!readSample(inPinI, sampleI)) return false;     //Read in raw current signal
+  pendingV = false;
+  return true;
+}
+
+//--------------------------------------------------------------------------------------
+// Processes the sample pair read by readVI() in the main measurement loop.
+//--------------------------------------------------------------------------------------
+void EnergyMonitor::sampleVI()
+{
+  numberOfSamples++;                       //Count number of times looped.
+  lastFilteredV = filteredV;               //Used for delay/phase compensation
+
+  //-----------------------------------------------------------------------------
+  // B) Apply digital low pass filters to extract the 2.5 V or 1.65 V dc offset,
+  //     then subtract this - signal is now centred on 0 counts.
+  //-----------------------------------------------------------------------------
+  filterV();
+  filterI();
+
+  //-----------------------------------------------------------------------------
+  // C) Root-mean-square method voltage
+  //-----------------------------------------------------------------------------
+  #if EMON_FIXED_POINT
+  sqV = (long)filteredV * filteredV;          //1) square voltage values
+  #else
+  sqV= filteredV * filteredV;                 //1) square voltage values
+  #endif
+  sumV += sqV;                                //2) sum
+
+  //-----------------------------------------------------------------------------
+  // D) Root-mean-square method current
+  //-----------------------------------------------------------------------------
+  #if EMON_FIXED_POINT
+  sqI = (long)filteredI * filteredI;          //1) square current values
+  #else
+  sqI = filteredI * filteredI;                //1) square current values
+  #endif
+  sumI += sqI;                                //2) sum
+
+  //-----------------------------------------------------------------------------
+  // E) Phase calibration
+  //-----------------------------------------------------------------------------
+  #if EMON_FIXED_POINT
+  phaseShiftedV = lastFilteredV + (((long)phasecal * (filteredV - lastFilteredV)) >> EMON_PHASECAL_BITS);
+  #else
+  phaseShiftedV = lastFilteredV + PHASECAL * (filteredV - lastFilteredV);
+  #endif
+
+  //-----------------------------------------------------------------------------
+  // F) Instantaneous power calc
+  //-----------------------------------------------------------------------------
+  instP = phaseShiftedV * filteredI;          //Instantaneous Power
+  sumP +=instP;                               //Sum
+
+  //-----------------------------------------------------------------------------
+  // G) Find the number of times the voltage has crossed the initial voltage
+  //    - every 2 crosses we will have sampled 1 wavelength
+  //    - so this method allows us to sample an integer number of half wavelengths which increases accuracy
+  //-----------------------------------------------------------------------------
+  lastVCross = checkVCross;
+  if (sampleV > startV) checkVCross = true;
+                   else checkVCross = false;
+  if (numberOfSamples==1) lastVCross = checkVCross;
+
+  if (lastVCross != checkVCross) crossCount++;
+}
+
+//--------------------------------------------------------------------------------------
+// Reads and filters a single current sample (current-only mode).
+// Returns false if the sample reader has no sample available yet.
+//--------------------------------------------------------------------------------------
+boolean EnergyMonitor::readI()
+{
+  if (!readSample(inPinI, sampleI)) return false;
+  filterI();
+  return true;
+}
+
+//--------------------------------------------------------------------------------------
+// Low pass filters that track the dc offset of sampleV / sampleI and remove it.
+// In fixed point the offset is kept with EMON_OFFSET_BITS fractional bits and decays
+// by 2^-EMON_FILTER_SHIFT per sample, the same time constant as the double filter.
+//--------------------------------------------------------------------------------------
+void EnergyMonitor::filterV()
+{
+  #if EMON_FIXED_POINT
+  offsetV += (((long)sampleV << EMON_OFFSET_BITS) - offsetV) >> EMON_FILTER_SHIFT;
+  filteredV = (((long)sampleV << EMON_OFFSET_BITS) - offsetV) >> (EMON_OFFSET_BITS - EMON_FRACTION_BITS);
+  #else
+  offsetV = offsetV + ((sampleV-offsetV)/1024);
+  filteredV = sampleV - offsetV;
+  #endif
+}
+
+void EnergyMonitor::filterI()
+{
+  #if EMON_FIXED_POINT
+  offsetI += (((long)sampleI << EMON_OFFSET_BITS) - offsetI) >> EMON_FILTER_SHIFT;
+  filteredI = (((long)sampleI << EMON_OFFSET_BITS) - offsetI) >> (EMON_OFFSET_BITS - EMON_FRACTION_BITS);
+  #else
+  offsetI = offsetI + ((sampleI-offsetI)/1024);
+  filteredI = sampleI - offsetI;
+  #endif
+}
+
+//--------------------------------------------------------------------------------------
+// Adds the last current sample (see readI()) to the rms sum (current-only mode).
+// Returns true if it ends a half wave (see crossedI()).
+//--------------------------------------------------------------------------------------
+boolean EnergyMonitor::accumulateI()
+{
+  numberOfSamples++;
+  #if EMON_FIXED_POINT
+  sqI = (long)filteredI * filteredI;
+  #else
+  sqI = filteredI * filteredI;
+  #endif
+  sumI += sqI;
+  return crossedI();
+}
+
+//--------------------------------------------------------------------------------------
+// true if the last current sample is past the hysteresis band on the opposite
+// side of the one the waveform was last seen on (i.e. a half wave has ended).
+//--------------------------------------------------------------------------------------
+boolean EnergyMonitor::crossedI()
+{
+  signed char polarity = polarityI;
+  #if EMON_FIXED_POINT
+  if (filteredI > (EMON_I_HYSTERESIS << EMON_FRACTION_BITS)) polarity = 1;
+  else if (filteredI < -(EMON_I_HYSTERESIS << EMON_FRACTION_BITS)) polarity = -1;
+  #else
+  if (filteredI > EMON_I_HYSTERESIS) polarity = 1;
+  else if (filteredI < -EMON_I_HYSTERESIS) polarity = -1;
+  #endif
+
+  boolean crossed = (polarityI != 0) && (polarity != polarityI);
+  polarityI = polarity;
+  return crossed;
+}
+
+//--------------------------------------------------------------------------------------
+// 3) Post loop calculations
+//--------------------------------------------------------------------------------------
+void EnergyMonitor::finishVI()
+{
+  //Fixed point sums carry EMON_FRACTION_BITS fractional bits per factor.
+  #if EMON_FIXED_POINT
+  const double SCALE = 1.0 / (1 << EMON_FRACTION_BITS);
+  #else
+  const double SCALE = 1.0;
+  #endif
+
+  double I_RATIO = ICAL *((SupplyVoltage/1000.0) / (ADC_COUNTS)) * SCALE;
+
+  //Timed out without a single sample: the sums are 0, so are the results.
+  if (numberOfSamples == 0) numberOfSamples = 1;
+
+  if (!voltageVI)
+  {
+    Irms = I_RATIO * sqrt((double)sumI / numberOfSamples);
+    sumI = 0;
+    return;
   }
 
-  //-------------------------------------------------------------------------------------------------------------------------
-  // 3) Post loop calculations
-  //-------------------------------------------------------------------------------------------------------------------------
   //Calculation of the root of the mean of the voltage and current squared (rms)
   //Calibration coefficients applied.
 
-  double V_RATIO = VCAL *((SupplyVoltage/1000.0) / (ADC_COUNTS));
-  Vrms = V_RATIO * sqrt(sumV / numberOfSamples);
+  double V_RATIO = VCAL *((SupplyVoltage/1000.0) / (ADC_COUNTS)) * SCALE;
+  Vrms = V_RATIO * sqrt((double)sumV / numberOfSamples);
 
-  double I_RATIO = ICAL *((SupplyVoltage/1000.0) / (ADC_COUNTS));
-  Irms = I_RATIO * sqrt(sumI / numberOfSamples);
+  Irms = I_RATIO * sqrt((double)sumI / numberOfSamples);
 
   //Calculation power values
-  realPower = V_RATIO * I_RATIO * sumP / numberOfSamples;
+  realPower = V_RATIO * I_RATIO * (double)sumP / numberOfSamples;
   apparentPower = Vrms * Irms;
   powerFactor=realPower / apparentPower;
 
@@ -168,7 +504,6 @@ void EnergyMonitor::calcVI(unsigned int crossings, unsigned int timeout)
   sumV = 0;
   sumI = 0;
   sumP = 0;
-//--------------------------------------------------------------------------------------
 }
 
 //--------------------------------------------------------------------------------------
@@ -178,28 +513,34 @@ double EnergyMonitor::calcIrms(unsigned int Number_of_Samples)
   #if defined emonTxV3
     int SupplyVoltage=3300;
   #else
-    int SupplyVoltage = readVcc();
+    int SupplyVoltage = supplyVoltage();
   #endif
 
 
   for (unsigned int n = 0; n < Number_of_Samples; n++)
   {
-    sampleI = analogRead(inPinI);
+    waitSample(inPinI, sampleI);
 
     // Digital low pass filter extracts the 2.5 V or 1.65 V dc offset,
     //  then subtract this - signal is now centered on 0 counts.
-    offsetI = (offsetI + (sampleI-offsetI)/1024);
-    filteredI = sampleI - offsetI;
+    filterI();
 
     // Root-mean-square method current
     // 1) square current values
+    #if EMON_FIXED_POINT
+    sqI = (long)filteredI * filteredI;
+    #else
     sqI = filteredI * filteredI;
+    #endif
     // 2) sum
     sumI += sqI;
   }
 
   double I_RATIO = ICAL *((SupplyVoltage/1000.0) / (ADC_COUNTS));
-  Irms = I_RATIO * sqrt(sumI / Number_of_Samples);
+  #if EMON_FIXED_POINT
+  I_RATIO /= (1 << EMON_FRACTION_BITS);
+  #endif
+  Irms = I_RATIO * sqrt((double)sumI / Number_of_Samples);
 
   //Reset accumulators
   sumI = 0;
@@ -256,6 +597,9 @@ long EnergyMonitor::readVcc() {
   return result;
   #elif defined(__arm__)
   return (3300);                                  //Arduino Due
+  #elif defined(ARDUINO_NATIVE)
+  delay(2);                                        // Same Vref settling time as on AVR
+  return (5000);                                  //Native host build (lib/ArduinoNative models a 5V Nano)
   #else
   return (3300);                                  //Guess that other un-supported architectures will be running a 3.3V!
   #endif
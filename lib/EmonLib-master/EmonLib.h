@@ -41,11 +41,53 @@
 
 #define ADC_COUNTS  (1<<ADC_BITS)
 
+// fixed-point per-sample kernel: integer offset filter and sums of squares,
+// floating point is only used once per measurement to get the rms values.
+// Define EMON_FIXED_POINT as 0 to use the original double arithmetic.
+#ifndef EMON_FIXED_POINT
+#define EMON_FIXED_POINT 1
+#endif
+#define EMON_OFFSET_BITS    16                  // fractional bits of the offset filter state
+#define EMON_FILTER_SHIFT   10                  // offset += (sample - offset) / 2^10, as in the double filter
+#define EMON_FRACTION_BITS  (14 - ADC_BITS)     // fractional bits of filtered samples (they fit in an int16)
+#define EMON_PHASECAL_BITS  8                   // fractional bits of PHASECAL
+
+// half-width (in ADC counts) of the band around the offset that the current waveform
+// must leave on the opposite side to count a crossing in current-only mode (see beginI())
+#ifndef EMON_I_HYSTERESIS
+#define EMON_I_HYSTERESIS 3
+#endif
+
+// states of the incremental calcVI() state machine (see beginVI() / pollVI())
+#define EMON_VI_IDLE      0   // no measurement requested, or result already consumed
+#define EMON_VI_WAITING   1   // waiting for the voltage waveform to be close to mid-scale
+#define EMON_VI_SAMPLING  2   // accumulating samples until the requested crossings are seen
+#define EMON_VI_READY     3   // measurement finished, results available
+
+
+// default time between supply voltage measurements (see vccRefreshInterval()), in ms
+#ifndef EMON_VCC_REFRESH
+#define EMON_VCC_REFRESH 60000UL
+#endif
+
+// time (in ms) calcIrms() waits for a sample from the sample reader before
+// falling back to analogRead() (see sampleReader())
+#ifndef EMON_SAMPLE_TIMEOUT
+#define EMON_SAMPLE_TIMEOUT 10UL
+#endif
+
+// optional sample source (see sampleReader()): stores the next sample of pin in sample
+// and returns true, or returns false if none is available yet
+typedef boolean (*EmonSampleReader)(unsigned int pin, int &sample);
+// optional supply voltage source (in mV) that replaces readVcc()
+typedef long (*EmonVccReader)();
 
 class EnergyMonitor
 {
   public:
 
+    EnergyMonitor();
+
     void voltage(unsigned int _inPinV, double _VCAL, double _PHASECAL);
     void current(unsigned int _inPinI, double _ICAL);
 
@@ -53,10 +95,35 @@ class EnergyMonitor
     void currentTX(unsigned int _channel, double _ICAL);
 
     void calcVI(unsigned int crossings, unsigned int timeout);
+
+    // incremental version of calcVI(): beginVI() starts a measurement and each pollVI()
+    // processes at most maxSamples samples, so the caller's loop is never blocked for long
+    void beginVI(unsigned int crossings, unsigned int timeout);
+    boolean pollVI(unsigned int maxSamples);
+
+    // current-only versions: only the CT channel is sampled and the half waves are
+    // counted on the current waveform itself (Irms is the only result updated)
+    void calcI(unsigned int crossings, unsigned int timeout);
+    void beginI(unsigned int crossings, unsigned int timeout);
+
+    boolean measuring();
+    boolean ready();
+
+    // takes the samples from reader instead of analogRead() (e.g. an interrupt-driven
+    // ADC), and the supply voltage from vccReader instead of readVcc(), if not NULL
+    void sampleReader(EmonSampleReader reader, EmonVccReader vccReader = NULL);
+
     double calcIrms(unsigned int NUMBER_OF_SAMPLES);
     void serialprint();
 
     long readVcc();
+
+    // cached supply voltage: calcVI(), calcI() and calcIrms() only measure it (readVcc(),
+    // with its 2 ms settling delay) when the cached value is older than the refresh interval
+    long cachedVcc();
+    boolean vccAvailable();                           //true once cachedVcc() has a value (no measurement needed)
+    void refreshVcc();
+    void vccRefreshInterval(unsigned long interval);
     //Useful value variables
     double realPower,
       apparentPower,
@@ -81,6 +148,19 @@ class EnergyMonitor
     int sampleV;                        //sample_ holds the raw analog read value
     int sampleI;
 
+#if EMON_FIXED_POINT
+    int lastFilteredV,filteredV;             //Filtered_ is the raw analog value minus the DC offset (Q EMON_FRACTION_BITS)
+    int filteredI;
+    long offsetV;                            //Low-pass filter output (Q EMON_OFFSET_BITS)
+    long offsetI;                            //Low-pass filter output (Q EMON_OFFSET_BITS)
+    int phasecal;                            //PHASECAL (Q EMON_PHASECAL_BITS)
+
+    long phaseShiftedV;                               //Holds the calibrated phase shifted voltage.
+
+    long sqV,sqI,instP;                               //sq = squared, inst = instantaneous
+    uint64_t sumV,sumI;                               //sum = Sum (Q 2*EMON_FRACTION_BITS)
+    int64_t sumP;
+#else
     double lastFilteredV,filteredV;          //Filtered_ is the raw analog value minus the DC offset
     double filteredI;
     double offsetV;                          //Low-pass filter output
@@ -89,11 +169,44 @@ class EnergyMonitor
     double phaseShiftedV;                             //Holds the calibrated phase shifted voltage.
 
     double sqV,sumV,sqI,sumI,instP,sumP;              //sq = squared, sum = Sum, inst = instantaneous
+#endif
 
     int startV;                                       //Instantaneous voltage at start of sample window.
 
     boolean lastVCross, checkVCross;                  //Used to measure number of times threshold is crossed.
 
+    //--------------------------------------------------------------------------------------
+    // State of the incremental calcVI() (see beginVI() / pollVI())
+    //--------------------------------------------------------------------------------------
+    unsigned char stateVI;
+    boolean voltageVI;                                //false for current-only measurements (beginI()).
+    signed char polarityI;                            //Side of the offset the current was last seen on.
+    unsigned int crossingsVI, timeoutVI;              //Requested crossings and timeout (ms).
+    unsigned int crossCount;                          //Number of times threshold has been crossed.
+    unsigned int numberOfSamples;
+    uint32_t startVI;                                 //millis() at the start of the current stage.
+    boolean pendingV;                                 //sampleV read, waiting for its sampleI (see readVI()).
+    int SupplyVoltage;
+
+    EmonSampleReader reader;
+    EmonVccReader vccReader;
+    long vcc;                                         //Cached supply voltage (mV).
+    boolean vccValid;
+    uint32_t vccMillis;                               //millis() of the last supply voltage measurement.
+    unsigned long vccInterval;
+    boolean readSample(unsigned int pin, int &sample);
+    void waitSample(unsigned int pin, int &sample);
+    long supplyVoltage();
+
+    boolean readVI();
+    void sampleVI();
+    void finishVI();
+    void filterV();
+    void filterI();
+    boolean readI();
+    boolean accumulateI();
+    boolean crossedI();
+
 
 };
 
@@ -74,6 +74,7 @@ LoRaClass::LoRaClass() :
   _ss(LORA_DEFAULT_SS_PIN), _reset(LORA_DEFAULT_RESET_PIN), _dio0(LORA_DEFAULT_DIO0_PIN),
   _frequency(0),
   _packetIndex(0),
+  _txLength(0),
   _implicitHeaderMode(0),
   _onReceive(NULL),
   _onTxDone(NULL)
@@ -176,14 +177,16 @@ int LoRaClass::beginPacket(int implicitHeader)
 
   // reset FIFO address and paload length
   writeRegister(REG_FIFO_ADDR_PTR, 0);
-  writeRegister(REG_PAYLOAD_LENGTH, 0);
+  _txLength = 0;
 
   return 1;
 }
 
 int LoRaClass::endPacket(bool async)
 {
-  
+  // the length is tracked locally by write(), set it once before TX
+  writeRegister(REG_PAYLOAD_LENGTH, _txLength);
+
   if ((async) && (_onTxDone))
       writeRegister(REG_DIO_MAPPING_1, 0x40); // DIO0 => TXDONE
 
@@ -302,20 +305,16 @@ size_t LoRaClass::write(uint8_t byte)
 
 size_t LoRaClass::write(const uint8_t *buffer, size_t size)
 {
-  int currentLength = readRegister(REG_PAYLOAD_LENGTH);
-
   // check size
-  if ((currentLength + size) > MAX_PKT_LENGTH) {
-    size = MAX_PKT_LENGTH - currentLength;
+  if ((_txLength + size) > MAX_PKT_LENGTH) {
+    size = MAX_PKT_LENGTH - _txLength;
   }
 
-  // write data
-  for (size_t i = 0; i < size; i++) {
-    writeRegister(REG_FIFO, buffer[i]);
-  }
+  // write data in a single burst, the FIFO address pointer auto-increments
+  burstWrite(REG_FIFO, buffer, size);
 
   // update length
-  writeRegister(REG_PAYLOAD_LENGTH, currentLength + size);
+  _txLength += size;
 
   return size;
 }
@@ -336,6 +335,26 @@ int LoRaClass::read()
   return readRegister(REG_FIFO);
 }
 
+size_t LoRaClass::readBytes(uint8_t *buffer, size_t length)
+{
+  // read the remaining length once
+  int remaining = available();
+
+  if (remaining <= 0) {
+    return 0;
+  }
+  if (length > (size_t)remaining) {
+    length = remaining;
+  }
+
+  // drain the FIFO in a single burst, the FIFO address pointer auto-increments
+  burstRead(REG_FIFO, buffer, length);
+
+  _packetIndex += length;
+
+  return length;
+}
+
 int LoRaClass::peek()
 {
   if (!available()) {
@@ -746,6 +765,42 @@ uint8_t LoRaClass::singleTransfer(uint8_t address, uint8_t value)
   return response;
 }
 
+void LoRaClass::burstWrite(uint8_t address, const uint8_t *buffer, size_t size)
+{
+  if (size == 0) {
+    return;
+  }
+
+  digitalWrite(_ss, LOW);
+
+  _spi->beginTransaction(_spiSettings);
+  _spi->transfer(address | 0x80);
+  for (size_t i = 0; i < size; i++) {
+    _spi->transfer(buffer[i]);
+  }
+  _spi->endTransaction();
+
+  digitalWrite(_ss, HIGH);
+}
+
+void LoRaClass::burstRead(uint8_t address, uint8_t *buffer, size_t size)
+{
+  if (size == 0) {
+    return;
+  }
+
+  digitalWrite(_ss, LOW);
+
+  _spi->beginTransaction(_spiSettings);
+  _spi->transfer(address & 0x7f);
+  for (size_t i = 0; i < size; i++) {
+    buffer[i] = _spi->transfer(0x00);
+  }
+  _spi->endTransaction();
+
+  digitalWrite(_ss, HIGH);
+}
+
 ISR_PREFIX void LoRaClass::onDio0Rise()
 {
   LoRa.handleDio0Rise();
@@ -57,6 +57,10 @@ public:
   virtual int peek();
   virtual void flush();
 
+  // burst read of the received packet, replaces Stream's byte-by-byte version
+  using Stream::readBytes;
+  size_t readBytes(uint8_t *buffer, size_t length);
+
 #ifndef ARDUINO_SAMD_MKRWAN1300
   void onReceive(void(*callback)(int));
   void onTxDone(void(*callback)());
@@ -109,6 +113,8 @@ private:
   uint8_t readRegister(uint8_t address);
   void writeRegister(uint8_t address, uint8_t value);
   uint8_t singleTransfer(uint8_t address, uint8_t value);
+  void burstWrite(uint8_t address, const uint8_t *buffer, size_t size);
+  void burstRead(uint8_t address, uint8_t *buffer, size_t size);
 
   static void onDio0Rise();
 
@@ -120,6 +126,7 @@ private:
   int _dio0;
   long _frequency;
   int _packetIndex;
+  int _txLength;
   int _implicitHeaderMode;
   void (*_onReceive)(int);
   void (*_onTxDone)();
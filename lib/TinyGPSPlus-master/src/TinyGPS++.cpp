@@ -39,16 +39,34 @@ TinyGPSPlus::TinyGPSPlus()
   ,  curTermNumber(0)
   ,  curTermOffset(0)
   ,  sentenceHasFix(false)
+  ,  filterSentences(false)
+  ,  skipSentence(false)
   ,  customElts(0)
   ,  customCandidates(0)
   ,  encodedCharCount(0)
   ,  sentencesWithFixCount(0)
   ,  failedChecksumCount(0)
   ,  passedChecksumCount(0)
+  ,  skippedSentenceCount(0)
 {
   term[0] = '\0';
 }
 
+// class of every character below '@' ('$', '*', ',', '\r' and '\n' are all there),
+// the rest of the characters are ordinary
+static const uint8_t charClasses[0x40] PROGMEM =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, _GPS_CHAR_END, 0, 0, _GPS_CHAR_END, 0, 0,                    // 0x00
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,                                            // 0x10
+  0, 0, 0, 0, _GPS_CHAR_START, 0, 0, 0, 0, 0, _GPS_CHAR_CHECKSUM, 0, _GPS_CHAR_TERM, 0, 0, 0, // 0x20
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0                                             // 0x30
+};
+
+static inline uint8_t classOf(char c)
+{
+  return (uint8_t)c < sizeof(charClasses) ? pgm_read_byte(&charClasses[(uint8_t)c]) : _GPS_CHAR_ORDINARY;
+}
+
 //
 // public methods
 //
@@ -57,13 +75,70 @@ bool TinyGPSPlus::encode(char c)
 {
   ++encodedCharCount;
 
-  switch(c)
+  // nothing but the next '$' matters in a dropped sentence
+  if (skipSentence && c != '$')
+    return false;
+
+  uint8_t charClass = classOf(c);
+  if (charClass == _GPS_CHAR_ORDINARY)
+  {
+    termChar(c);
+    return false;
+  }
+  return encodeClass(c, charClass);
+}
+
+uint16_t TinyGPSPlus::encode(const char *buf, size_t len)
+{
+  uint16_t validSentences = 0;
+  const char *end = buf + len;
+
+  encodedCharCount += len;
+  while (buf < end)
   {
-  case ',': // term terminators
+    if (skipSentence)
+    {
+      buf = (const char *)memchr(buf, '$', end - buf);
+      if (buf == NULL)
+        break;
+    }
+
+    char c = *buf++;
+    uint8_t charClass = classOf(c);
+    if (charClass == _GPS_CHAR_ORDINARY)
+      termChar(c);
+    else if (encodeClass(c, charClass))
+    {
+      ++validSentences;
+    }
+  }
+
+  return validSentences;
+}
+
+//
+// internal utilities
+//
+int TinyGPSPlus::fromHex(char a)
+{
+  if (a >= 'A' && a <= 'F')
+    return a - 'A' + 10;
+  else if (a >= 'a' && a <= 'f')
+    return a - 'a' + 10;
+  else
+    return a - '0';
+}
+
+// Processes a character of the given class (see classOf())
+// Returns true if new sentence has just passed checksum test and is validated
+bool TinyGPSPlus::encodeClass(char c, uint8_t charClass)
+{
+  switch(charClass)
+  {
+  case _GPS_CHAR_TERM: // term terminators
     parity ^= (uint8_t)c;
-  case '\r':
-  case '\n':
-  case '*':
+  case _GPS_CHAR_END:
+  case _GPS_CHAR_CHECKSUM:
     {
       bool isValidSentence = false;
       if (curTermOffset < sizeof(term))
@@ -71,45 +146,36 @@ bool TinyGPSPlus::encode(char c)
         term[curTermOffset] = 0;
         isValidSentence = endOfTermHandler();
       }
+      // drop the sentence as soon as its type is known to be of no interest
+      if (curTermNumber == 0 && filterSentences && curSentenceType == GPS_SENTENCE_OTHER && customCandidates == NULL)
+      {
+        skipSentence = true;
+        ++skippedSentenceCount;
+      }
       ++curTermNumber;
       curTermOffset = 0;
-      isChecksumTerm = c == '*';
+      isChecksumTerm = charClass == _GPS_CHAR_CHECKSUM;
       return isValidSentence;
     }
     break;
 
-  case '$': // sentence begin
+  case _GPS_CHAR_START: // sentence begin
     curTermNumber = curTermOffset = 0;
     parity = 0;
     curSentenceType = GPS_SENTENCE_OTHER;
     isChecksumTerm = false;
     sentenceHasFix = false;
+    skipSentence = false;
     return false;
 
   default: // ordinary characters
-    if (curTermOffset < sizeof(term) - 1)
-      term[curTermOffset++] = c;
-    if (!isChecksumTerm)
-      parity ^= c;
+    termChar(c);
     return false;
   }
 
   return false;
 }
 
-//
-// internal utilities
-//
-int TinyGPSPlus::fromHex(char a)
-{
-  if (a >= 'A' && a <= 'F')
-    return a - 'A' + 10;
-  else if (a >= 'a' && a <= 'f')
-    return a - 'a' + 10;
-  else
-    return a - '0';
-}
-
 // static
 // Parse a (potentially negative) number with up to 2 decimal digits -xxxx.yy
 int32_t TinyGPSPlus::parseDecimal(const char *term)
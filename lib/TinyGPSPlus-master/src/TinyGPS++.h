@@ -40,6 +40,13 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #define _GPS_FEET_PER_METER 3.2808399
 #define _GPS_MAX_FIELD_SIZE 15
 
+// character classes of encode() (see the table in TinyGPS++.cpp)
+#define _GPS_CHAR_ORDINARY  0 // part of a term
+#define _GPS_CHAR_TERM      1 // ',' ends a term
+#define _GPS_CHAR_CHECKSUM  2 // '*' ends the last term, the checksum follows
+#define _GPS_CHAR_END       3 // '\r' or '\n' ends the sentence
+#define _GPS_CHAR_START     4 // '$' begins a sentence
+
 struct RawDegrees
 {
    uint16_t deg;
@@ -222,6 +229,13 @@ public:
   TinyGPSPlus();
   bool encode(char c); // process one character received from GPS
   TinyGPSPlus &operator << (char c) {encode(c); return *this;}
+  // process len characters at once, returns the number of sentences that passed the checksum test
+  uint16_t encode(const char *buf, size_t len);
+
+  // when enabled, a sentence that is neither GGA nor RMC (and has no TinyGPSCustom
+  // listening to it) is dropped right after its first term: the rest of it is skipped
+  // up to the next '$', without term buffering, parity or checksum test
+  void sentenceFilter(bool enable) { filterSentences = enable; }
 
   TinyGPSLocation location;
   TinyGPSDate date;
@@ -245,6 +259,7 @@ public:
   uint32_t sentencesWithFix() const { return sentencesWithFixCount; }
   uint32_t failedChecksum()   const { return failedChecksumCount; }
   uint32_t passedChecksum()   const { return passedChecksumCount; }
+  uint32_t sentencesSkipped() const { return skippedSentenceCount; }
 
 private:
   enum {GPS_SENTENCE_GPGGA, GPS_SENTENCE_GPRMC, GPS_SENTENCE_OTHER};
@@ -257,6 +272,8 @@ private:
   uint8_t curTermNumber;
   uint8_t curTermOffset;
   bool sentenceHasFix;
+  bool filterSentences;
+  bool skipSentence;
 
   // custom element support
   friend class TinyGPSCustom;
@@ -269,9 +286,18 @@ private:
   uint32_t sentencesWithFixCount;
   uint32_t failedChecksumCount;
   uint32_t passedChecksumCount;
+  uint32_t skippedSentenceCount;
 
   // internal utilities
   int fromHex(char a);
+  void termChar(char c)
+  {
+    if (curTermOffset < sizeof(term) - 1)
+      term[curTermOffset++] = c;
+    if (!isChecksumTerm)
+      parity ^= c;
+  }
+  bool encodeClass(char c, uint8_t charClass);
   bool endOfTermHandler();
 };
 
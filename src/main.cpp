@@ -4,7 +4,7 @@
     @file nodo-sisicic.ino
     @author Franco Abosso
     @author Julio Donadello
-    @version 1.1 29/03/2021
+    @version 1.2 16/10/2026
 */
 
 /// Headers iniciales (preceden a la declaración de variables).
@@ -12,6 +12,24 @@
 // Header que contiene constantes relevantes al accionar de este programa.
 #include "constants.h"          // Biblioteca propia.
 
+// Header que define la carga útil binaria de LoRa (compartido con el concentrador).
+#include "binary_payload.h"     // Biblioteca propia.
+
+// Header que modela el tiempo en el aire LoRa y verifica el ciclo de trabajo al compilar.
+#include "airtime_helpers.h"    // Biblioteca propia.
+
+// Header que define el acumulador de estadísticas en línea (media, mínimo, máximo y desvío).
+#include "stats_helpers.h"      // Biblioteca propia.
+
+// Header que define el planificador cooperativo de tareas periódicas.
+#include "scheduler.h"          // Biblioteca propia.
+
+// Header que define el acumulador del perfilador de tiempos de ejecución.
+#include "profiler.h"           // Biblioteca propia.
+
+// Header que define el despachador de eventos.
+#include "events.h"             // Biblioteca propia.
+
 // Bibliotecas necesarias para manejar al SX1278.
 #include <SPI.h>                // https://www.arduino.cc/en/reference/SPI
 #include <LoRa.h>               // https://github.com/sandeepmistry/arduino-LoRa
@@ -28,32 +46,69 @@
 // Biblioteca necesaria para manejar el GPS.
 #include <TinyGPS++.h>          // https://github.com/mikalhart/TinyGPSPlus
 
-// Biblioteca necesaria para emular otro puerto serie.
-#include <SoftwareSerial.h>     // https://www.arduino.cc/en/Reference/SoftwareSerial
+// Biblioteca necesaria para emular otro puerto serie (sólo con GPS_UART == GPS_UART_SOFTWARE).
+#if GPS_UART == GPS_UART_SOFTWARE
+    #include <SoftwareSerial.h> // https://www.arduino.cc/en/Reference/SoftwareSerial
+#endif
 
 // Biblioteca necesaria para utilizar el watchdog timer. 
 #include <avr/wdt.h>            // https://www.nongnu.org/avr-libc/user-manual/group__avr__watchdog.html
 
+// Bibliotecas necesarias para dormir al MCU y apagar los periféricos sin uso (ver power.h).
+#if defined(__AVR__)
+    #include <avr/sleep.h>      // https://www.nongnu.org/avr-libc/user-manual/group__avr__sleep.html
+    #include <avr/power.h>      // https://www.nongnu.org/avr-libc/user-manual/group__avr__power.html
+#endif
+
 /// Declaración de variables globales.
 
 /**
-    currents es un array de floats que contiene los valores de corriente medidos entre cada
-    transmisión LoRa. El tamaño del array depende del intervalo de tiempo entre cada transmisión
-    LoRa y el intervalo de tiempo entre cada medición.
-    El valor que se transmite por LoRa en realidad es el valor promedio de este array.
-    Una vez realizada la transmisión, todos los valores de este array vuelven a ponerse en 0.
+    scheduler contiene las tareas periódicas del nodo (TASK_REPORT, TASK_SENSORS, TASK_BUZZER,
+    TASK_GPS y TASK_PROFILE),
+    ordenadas por vencimiento. loop() ejecuta las vencidas con runDueTasks().
+*/
+Scheduler scheduler;
+
+/**
+    events contiene los eventos pendientes del nodo (EVENT_CURRENT a EVENT_GPS) y sus manejadores.
+    loop() ejecuta los manejadores de los pendientes con runPendingEvents(). Reemplaza a los flags
+    de pedido (de medición, de alerta, de posición y de mensajes LoRa) que loop() consultaba
+    de a uno en cada pasada.
 */
-float currents[ARRAY_SIZE] = {0.0};
+EventDispatcher events;
+
+#if PROFILER
+    /**
+        profile contiene una sonda del perfilador por cada bloque medido (PROBE_LOOP y siguientes)
+        y profileNames, sus nombres cortos, en la memoria flash (ver profiler.h).
+    */
+    ProfileProbe profile[PROFILER_PROBES];
+    const char profileNames[PROFILER_PROBES][4] PROGMEM = {"lp", "rep", "cur", "rn", "gas", "lr", "gps"};
+
+    /**
+        profileUplinkRequested es un flag que representa el pedido de un paquete LoRa de diagnóstico
+        (comando LoRa "prof"). Vuelve a ponerse en false al encolarse (ver profileObserver()).
+    */
+    bool profileUplinkRequested = false;
+#endif
 
 /**
-    raindrops es un array de enteros con signo que contiene los resultados del polleo del pin de lluvia
-    efectuados entre cada transmisión LoRa.
-    El tamaño del array depende del intervalo de tiempo entre cada transmisión 
-    LoRa y el intervalo de tiempo entre cada medición.
-    El valor que se transmite por LoRa en realidad es el resultado de una votación para evitar falsos positivos.
-    Una vez realizada la transmisión, todos los valores de este array vuelven a ponerse en -1.
+    currentStats acumula los valores de corriente medidos durante la ventana actual
+    (cantidad, media, mínimo, máximo y varianza; ver stats_helpers.h), sin guardarlos.
+    El valor que se transmite por LoRa es la media (y, con REPORT_CURRENT_STATS,
+    también el mínimo, el máximo y el desvío estándar).
+    Al cerrarse la ventana, se vacía con statsReset().
 */
-int raindrops[ARRAY_SIZE] = {-1};
+RunningStats currentStats = {0, 0.0, 0.0, 0.0, 0.0};
+
+/**
+    rainVotes cuenta los votos de lluvia (muestras mojadas y secas) de la ventana actual
+    y rainWet es el estado del sensor de lluvia luego de la histéresis (ver getNewRaindrop()).
+    El valor que se transmite por LoRa es el resultado de la votación, para evitar falsos positivos.
+    Al cerrarse la ventana, los votos se vacían con votesReset(); rainWet se conserva.
+*/
+VoteCounter rainVotes = {0, 0};
+bool rainWet = false;
 
 /**
     gas es un float que almacena la cantidad de litros de combustible presentes
@@ -62,122 +117,337 @@ int raindrops[ARRAY_SIZE] = {-1};
 float gas = 0.0;
 
 /**
-    index es una variable de tipo int utilizado para recorrer los arrays de medición.
-    Una vez realizada la transmisión, vuelve a ponerse en 0.
+    gasState contiene el estado de la medición asíncrona de combustible (GAS_IDLE, GAS_ECHO o GAS_PAUSE).
+    pingMicros almacena el instante (en us) en que se disparó el último ping, pingsFired la cantidad
+    de pings disparados en la medición actual y pingsEchoed la cantidad de ecos recibidos,
+    cuyos tiempos (en us) se guardan en pingTimes en orden descendente (ver addPingTime()).
 */
-int index = 0;
+uint8_t gasState = GAS_IDLE;
+uint32_t pingMicros = 0;
+uint8_t pingsFired = 0;
+uint8_t pingsEchoed = 0;
+unsigned int pingTimes[PING_SAMPLES];
 
 /**
-    refreshRequested contiene SENSORS_QTY variables booleanas que representan la necesidad
-    inmediata de refrescar los valores de los arrays de medición. Estos tienen un orden arbitrario:
-    { Corriente, Lluvia  }
-    Una vez refrescado, cada uno de estos booleanos vuelve a ponerse en false.
+    pingEcho almacena el tiempo de eco (en us) del último ping y pingDone se pone en true al recibirlo.
+    Ambos los escribe echoCheck(), en contexto de interrupción (Timer2).
 */
-bool refreshRequested[SENSORS_QTY] = {false};
+volatile unsigned int pingEcho = NO_ECHO;
+volatile bool pingDone = false;
 
 /**
-    gasRequested es un flag que representa la necesidad inmediata de volver a medir el nivel
-    de combustible del grupo electrógeno.
-    Se diferencia de los otros sensores (los controlados por refreshRequested) porque esta medición
-    se realiza una vez cada LORA_TIMEOUT segundos (no una vez cada TIMEOUT_READ_SENSORS segundos).
+    GPSRequestFixes almacena el valor de GPS.sentencesWithFix() al pedirse la posición (EVENT_GPS):
+    el pedido se cumple cuando deja de valer eso (ver gpsFixObserver()).
+    Con GPS_POWER_SAVE, el pedido lo hace TASK_GPS una vez por ventana y GPSRequestMillis almacena
+    el instante (en ms) en que lo hizo, para desistir luego de GPS_FIX_TIMEOUT ms.
 */
-bool gasRequested = true;
+uint32_t GPSRequestFixes = 0;
+uint32_t GPSRequestMillis = 0;
 
 /**
-    GPSRequested es un flag que representa la necesidad inmediata de volver a leer la posición
-    del GPS.
-    Se diferencia de los otros sensores (los controlados por refreshRequested) porque esta medición
-    se realiza una vez cada LORA_TIMEOUT segundos (no una vez cada TIMEOUT_READ_SENSORS segundos).
+    gpsAsleep es un flag que indica que el GPS está en modo backup hasta el instante
+    gpsBackupUntil (en ms), y gpsBackupMillis el tiempo en modo backup pedido desde
+    el comienzo de la ventana actual (en ms; ver gpsBackup()).
 */
-bool GPSRequested = true;
+bool gpsAsleep = false;
+uint32_t gpsBackupUntil = 0;
+unsigned long gpsBackupMillis = 0;
 
 /**
-    outcomingFull es una string que contiene el mensaje LoRa de salida preformateado especialmente
-    para que, posteriormente, el concentrador LoRa pueda decodificarla.
+    LoRaTxState contiene el estado de la transmisión LoRa asíncrona (TX_IDLE, TX_BUSY o TX_DONE).
+    loop() lo pasa a TX_BUSY al encolar un paquete, la interrupción onTxDone() a TX_DONE
+    y LoRaTxObserver() nuevamente a TX_IDLE, luego de volver a poner al SX1278 en modo recepción.
 */
-String outcomingFull;
+volatile uint8_t LoRaTxState = TX_IDLE;
 
 /**
-    incomingFull es una string que contiene el mensaje LoRa de entrada, incluyendo
-    el identificador de nodo.
+    LoRaTxMillis almacena el instante (en ms) en que se encoló el último paquete LoRa.
+    LoRaTxObserver() lo utiliza para detectar una interrupción TxDone perdida.
 */
-String incomingFull;
+uint32_t LoRaTxMillis = 0;
 
 /**
-    incomingFullComplete es un flag que se pone en true luego de completarse la función de interrupción
-    onRecieve de LoRa, provisto que la carga útil sea una string con entre 0 y INCOMING_FULL_MAX_SIZE 
-    bytes.  
+    radioMode contiene el modo del SX1278 (RADIO_RX, RADIO_SLEEP o RADIO_TX) y radioMillis,
+    el instante (en ms) en que entró en ese modo (ver power.h).
 */
-bool incomingFullComplete = false;
+uint8_t radioMode = RADIO_RX;
+uint32_t radioMillis = 0;
 
 /**
-    greaterThanStr (>) es el delimitador entre el identificador de nodo y la carga útil
-    del mensaje de entrada LoRa. Se carga en memoria una única vez en una String constante
-    para evitar problemas de memoria heap.
+    Acumuladores de la estimación de energía de la ventana actual (ver powerCloseCycle()):
+        - powerCycleMillis es el instante (en ms) en que empezó la ventana,
+        - powerCycleAirtime, el valor de LoRaTotalAirtime en ese instante,
+        - powerIdleMicros, el tiempo que el MCU pasó en SLEEP_MODE_IDLE (en us),
+        - powerDownMillis, el tiempo que pasó en power-down (en ms),
+        - powerRxMillis, el tiempo que el SX1278 pasó en recepción (en ms).
+    powerLastCycle es la energía estimada de la última ventana cerrada (en mJ).
 */
-const String greaterThanStr = ">";
+uint32_t powerCycleMillis = 0;
+unsigned long powerCycleAirtime = 0;
+unsigned long powerIdleMicros = 0;
+unsigned long powerDownMillis = 0;
+unsigned long powerRxMillis = 0;
+float powerLastCycle = 0.0;
 
 /**
-    receiverStr es una string que sólo contiene el identificador de nodo
-    recibido en un mensaje LoRa entrante.
+    LoRaLastAirtime almacena el tiempo en el aire (en us) del último paquete LoRa encolado
+    y LoRaTotalAirtime, el acumulado desde el arranque (en ms), según timeOnAir().
 */
-String receiverStr;
+unsigned long LoRaLastAirtime = 0;
+unsigned long LoRaTotalAirtime = 0;
+
+#if LORA_REPORT_MODE == REPORT_MODE_EXCEPTION
+    /**
+        lastReportValid es un flag que se pone en true una vez encolado el primer reporte LoRa.
+        Hasta entonces, no hay valores contra los cuales comparar (ver isReportDue()).
+    */
+    bool lastReportValid = false;
+
+    /**
+        lastReportMillis almacena el cierre de ventana (en ms) en que salió al aire el último paquete
+        de reportes (ver rememberReportSent()).
+    */
+    uint32_t lastReportMillis = 0;
+
+    /**
+        lastReportCurrent almacena la corriente (en A) enviada en el último reporte LoRa.
+    */
+    float lastReportCurrent = 0.0;
+
+    /**
+        lastReportRaindrop almacena el último resultado de la votación de lluvia enviado (0 ó 1).
+    */
+    int lastReportRaindrop = -1;
+
+    /**
+        lastReportGas almacena el combustible (en L) enviado en el último reporte LoRa.
+    */
+    float lastReportGas = 0.0;
+
+    /**
+        lastReportGPSValid indica si el último reporte LoRa incluyó una posición válida,
+        almacenada en lastReportLat y lastReportLng (en grados).
+    */
+    bool lastReportGPSValid = false;
+    double lastReportLat = 0.0;
+    double lastReportLng = 0.0;
+#endif
 
 /**
-    incomingPayload es una string que contiene sólo la carga útil del mensaje LoRa de entrada,
-    utilizada sólo cuando el identificador de nodo coincide con DEVICE_ID o con BROADCAST_ID.
+    WindowCurrent contiene la corriente de una ventana cerrada, reducida a los valores que se
+    reportan (ver reduceCurrent()): la media redondeada a 2 decimales (NaN si no hubo mediciones)
+    y, sólo con REPORT_CURRENT_STATS, el mínimo, el máximo y el desvío estándar en centiamperes
+    (BINARY_PAYLOAD_NO_CURRENT si no hubo mediciones), como en el payload binario.
+    Ocupa 4 bytes (10 con REPORT_CURRENT_STATS), en lugar de los 18 de un RunningStats.
 */
-String incomingPayload;
+struct WindowCurrent {
+    float mean;
+    #if REPORT_CURRENT_STATS
+        uint16_t min;
+        uint16_t max;
+        uint16_t stddev;
+    #endif
+};
 
 /**
-    knownCommands es un array de Strings que contiene los comandos LoRa que
-    se pueden ejecutar.
+    batchCurrents, batchRaindrops, batchGas y batchMillis forman un anillo de LORA_BATCH_MAX
+    ventanas pendientes de envío: los valores comprimidos de cada ventana de LORA_TIMEOUT segundos
+    (corriente, votación de lluvia y combustible) y el instante (en ms) en que se cerró.
+    batchHead es la posición donde se escribirá la próxima ventana y batchCount
+    la cantidad de ventanas pendientes. Al encolarse el paquete, batchCount vuelve a ponerse en 0.
 */
-const String knownCommands[KNOWN_COMMANDS_SIZE] = {
-    "startAlert"    // inicia una alerta con el siguiente llamado a función: startAlert(750, 10);
-};
+WindowCurrent batchCurrents[LORA_BATCH_MAX];
+int batchRaindrops[LORA_BATCH_MAX];
+float batchGas[LORA_BATCH_MAX];
+uint32_t batchMillis[LORA_BATCH_MAX];
+int batchHead = 0;
+int batchCount = 0;
 
 /**
-    latStr es una String que almacena temporalmente el valor de latitud devuelto por el GPS.
+    reportBatchSize es la cantidad de ventanas que se agrupan en cada paquete LoRa
+    (entre 1 y LORA_BATCH_MAX). Se modifica con el comando LoRa "batch=N".
 */
-String latStr;
+int reportBatchSize = LORA_BATCH_SIZE;
 
 /**
-    lngStr es una String que almacena temporalmente el valor de longitud devuelto por el GPS.
+    incomingFull es un buffer de caracteres (terminado en '\0') que contiene el mensaje LoRa
+    de entrada, incluyendo el identificador de nodo.
+    Lo completa onReceive() en contexto de interrupción, con una única lectura en ráfaga del FIFO,
+    provisto que el paquete tenga entre 1 y INCOMING_FULL_MAX_SIZE bytes.
 */
-String lngStr;
+char incomingFull[INCOMING_FULL_MAX_SIZE + 1];
 
 /**
-    altStr es una String que almacena temporalmente el valor de altitud devuelto por el GPS.
+    incomingPayload es una string que contiene sólo la carga útil del mensaje LoRa de entrada,
+    utilizada sólo cuando el identificador de nodo coincide con DEVICE_ID o con BROADCAST_ID.
+    Al completarse incomingFull, onReceive() deja pendiente EVENT_DOWNLINK; mientras lo esté,
+    los paquetes entrantes se descartan para no pisar incomingFull.
 */
-String altStr;
+String incomingPayload;
+
+/**
+    knownCommands es un array de Strings que contiene los comandos LoRa que
+    se pueden ejecutar.
+*/
+const String knownCommands[KNOWN_COMMANDS_SIZE] = {
+    "startAlert",   // inicia una alerta con el siguiente llamado a función: startAlert(750, 10);
+    "batch=",       // "batch=N" agrupa N ventanas por paquete LoRa: reportBatchSize = N;
+    "prof"          // envía el perfil de tiempos en un paquete de diagnóstico: profileUplinkRequested = true;
+};
+
+#if ADC_SAMPLING == ADC_SAMPLING_ENGINE
+    /**
+        adcRing contiene, por cada canal de adcChannels, un anillo de ADC_RING_SIZE muestras
+        que llena la interrupción del ADC y vacían sus consumidores (EmonLib y el sensor de lluvia).
+        adcHead sólo lo escribe la interrupción y adcTail sólo el consumidor; ambos avanzan
+        libremente (módulo 256), por lo que el anillo no necesita deshabilitar interrupciones.
+    */
+    volatile int adcRing[ADC_CHANNELS_QTY][ADC_RING_SIZE];
+    volatile uint8_t adcHead[ADC_CHANNELS_QTY];
+    volatile uint8_t adcTail[ADC_CHANNELS_QTY];
+
+    /**
+        adcLast contiene la última muestra convertida de cada canal, aunque su anillo esté lleno.
+    */
+    volatile int adcLast[ADC_CHANNELS_QTY];
+
+    /**
+        adcOverruns cuenta, por canal, las muestras descartadas porque el anillo estaba lleno
+        (lo habitual mientras nadie consume el canal, por ejemplo entre dos mediciones de corriente).
+    */
+    volatile unsigned int adcOverruns[ADC_CHANNELS_QTY];
+
+    /**
+        adcCurrent es la posición en adcChannels del canal que se está convirtiendo.
+    */
+    volatile uint8_t adcCurrent = 0;
+
+    /**
+        adcSkip es la cantidad de conversiones a descartar antes de volver a guardar muestras
+        (la primera conversión luego de medir la referencia interna no es confiable).
+    */
+    volatile uint8_t adcSkip = 0;
+#endif
+
+#if GPS_UART == GPS_UART_CAPTURE
+    /**
+        gpsRing es el anillo de caracteres recibidos del GPS, que llenan las interrupciones
+        de Timer1 (ver gps_uart.h) y vacía getNewGPS(). Como en los anillos del ADC,
+        gpsHead sólo lo escribe la interrupción y gpsTail sólo el consumidor (módulo 256).
+    */
+    volatile char gpsRing[GPS_RING_SIZE];
+    volatile uint8_t gpsHead = 0;
+    volatile uint8_t gpsTail = 0;
+
+    /**
+        gpsOverruns cuenta los caracteres descartados porque el anillo estaba lleno.
+    */
+    volatile unsigned int gpsOverruns = 0;
+
+    /**
+        Estado del carácter en recepción (sólo lo usan las interrupciones de Timer1):
+            - gpsRxBit es la cantidad de bits recibidos más uno (0 mientras se espera un start bit),
+            - gpsRxByte acumula los bits recibidos (primero el menos significativo),
+            - gpsRxLevel es el nivel de la línea desde el último flanco (0x80 en alto, 0 en bajo),
+            - gpsRxTarget es el instante (en ticks de Timer1) del centro del próximo bit.
+    */
+    uint8_t gpsRxBit = 0;
+    uint8_t gpsRxByte = 0;
+    uint8_t gpsRxLevel = 0x80;
+    uint16_t gpsRxTarget = 0;
+#endif
 
 /// Headers finales (proceden a la declaración de variables).
 
 #include "pinout.h"             // Biblioteca propia.
-#include "alerts.h"             // Biblioteca propia.
+#include "adc_engine.h"         // Biblioteca propia.
+#include "gps_uart.h"           // Biblioteca propia.
 #include "timing_helpers.h"     // Biblioteca propia.
+#include "alerts.h"             // Biblioteca propia.
 #include "sensors.h"            // Biblioteca propia.
 #include "actuators.h"          // Biblioteca propia.
 #include "decimal_helpers.h"    // Biblioteca propia.
-#include "array_helpers.h"      // Biblioteca propia.
+#include "report_helpers.h"     // Biblioteca propia.
+#include "power.h"              // Biblioteca propia.
 #include "LoRa_helpers.h"       // Biblioteca propia.
 
+/// Tareas periódicas (ver scheduler.h).
+
+/**
+    reportTask() es la tarea TASK_REPORT: cierra la ventana de medición, la encola
+    (salvo que, en modo por excepción, no haya cambios que reportar), transmite las ventanas
+    pendientes cuando corresponde (ver isBatchDue()) y abre la siguiente ventana.
+*/
+void reportTask() {
+    PROFILE(PROBE_REPORT);
+
+    // Deja de refrescar TODOS los sensores.
+    stopRefreshingAllSensors();
+
+    // Cierra la estimación de energía de la ventana.
+    powerCloseCycle();
+
+    // Comprime la ventana de medición que acaba de cerrarse.
+    WindowCurrent windowCurrent = reduceCurrent(currentStats);
+    int windowRaindrop = reportedRaindrop(rainVotes);
+    float windowGas = reportedGas(gas);
+
+    // Encola la ventana, salvo que (en modo por excepción) no haya cambios que reportar,
+    // y transmite las ventanas pendientes cuando corresponde.
+    bool windowQueued = isReportDue(windowCurrent.mean, windowRaindrop, windowGas);
+    if (windowQueued) {
+        pushBatchWindow(windowCurrent, windowRaindrop, windowGas);
+        rememberReport(windowCurrent.mean, windowRaindrop, windowGas);
+    } else {
+        #if DEBUG_LEVEL >= 2
+            Serial.println("Sin cambios, reporte omitido!");
+        #endif
+    }
+    if (isBatchDue(windowQueued) && sendLoRaBatch()) {
+        // Inicia la alerta preestablecida.
+        startAlert(133, 4);
+    }
+
+    // Reestablece las mediciones de la ventana.
+    statsReset(currentStats);
+    votesReset(rainVotes);
+
+    // Vuelve a pedir que se refresque el estado del nivel de combustible.
+    eventPost(EVENT_GAS);
+}
+
+/**
+    refreshTask() es la tarea TASK_SENSORS: pide el refresco de todos los sensores.
+*/
+void refreshTask() {
+    // Refresca TODOS los sensores (corriente y lluvia).
+    refreshAllSensors();
+    // Vuelve a pedir que se refresque el estado del GPS (con GPS_POWER_SAVE, lo hace TASK_GPS).
+    #if !GPS_POWER_SAVE
+        eventPost(EVENT_GPS);
+        GPSRequestFixes = GPS.sentencesWithFix();
+    #endif
+}
+
 /// Funciones principales.
 
 /**
     setup() lleva a cabo las siguientes tareas:
         - setea el pinout,
+        - inicia el muestreo del ADC en segundo plano (si ADC_SAMPLING == ADC_SAMPLING_ENGINE),
         - inicializa el periférico serial (real),
         - reserva espacios de memoria para las Strings,
-        - inicializa el periférico serial del GPS (virtual),
+        - inicializa el periférico serial del GPS (virtual) y el filtro de sentencias NMEA,
         - inicializa el módulo LoRa,
-        - inicializa el watchdog timer en 8 segundos.
+        - programa las tareas periódicas y asigna los manejadores de eventos,
+        - inicializa el watchdog timer en 8 segundos,
+        - apaga los periféricos del MCU sin uso.
     Si después de realizar estas tareas no se "cuelga", da inicio
     a una alerta "exitosa".
 */
 void setup() {
     setupPinout();
+    adcEngineBegin();
     #if DEBUG_LEVEL >= 1
         Serial.begin(SERIAL_BPS);
         Serial.println("Nodo exterior");
@@ -193,103 +463,77 @@ void setup() {
     #endif
     reserveMemory();
     LoRaInitialize();
-    ssGPS.begin(GPS_BPS);
-    startAlert(133, 4);
-    #if USE_WATCHDOG_TMR == TRUE
-        #if WATCHDOG_TMR >= 8 
-            wdt_enable(WDTO_8S);
-        #elif WATCHDOG_TMR >= 4
-            wdt_enable(WDTO_4S);
-        #elif WATCHDOG_TMR >= 2
-            wdt_enable(WDTO_2S);
-        #else
-            wdt_enable(WDTO_1S);
-        #endif
+    gpsUartBegin();
+    GPS.sentenceFilter(GPS_SENTENCE_FILTER);
+    schedulerReset(scheduler);
+    taskEvery(TASK_REPORT, reportTask, sec2ms(LORA_TIMEOUT));
+    taskEvery(TASK_SENSORS, refreshTask, sec2ms(TIMEOUT_READ_SENSORS));
+    #if GPS_POWER_SAVE
+        // El GPS despierta GPS_WAKE_LEAD ms antes de cada reporte.
+        taskStart(scheduler, TASK_GPS, gpsWakeTask, sec2ms(LORA_TIMEOUT),
+            sec2ms(LORA_TIMEOUT) - GPS_WAKE_LEAD, TASK_GPS, millis());
+        GPSRequestMillis = millis();
     #endif
+    #if PROFILER
+        taskEvery(TASK_PROFILE, profileTask, sec2ms(PROFILER_DUMP_TIMEOUT));
+    #endif
+    eventsReset(events);
+    eventHandle(events, EVENT_CURRENT, currentObserver);
+    eventHandle(events, EVENT_RAIN, getNewRaindrop);
+    eventHandle(events, EVENT_GAS, gasObserver);
+    eventHandle(events, EVENT_ALERT, alertObserver);
+    eventHandle(events, EVENT_DOWNLINK, downlinkObserver);
+    eventHandle(events, EVENT_COMMAND, LoRaCmdObserver);
+    eventHandle(events, EVENT_GPS, gpsFixObserver);
+    // Al arrancar, se pide medir el combustible y leer la posición sin esperar a las tareas.
+    eventPost(EVENT_GAS);
+    eventPost(EVENT_GPS);
+    startAlert(133, 4);
+    watchdogBegin();
+    powerBegin();
 }
 
 /**
     loop() determina las tareas que cumple el programa:
-        - cada LORA_TIMEOUT segundos, envía un payload LoRa.
-        - si corresponde, mide corriente, lluvia, combustible y GPS.
+        - ejecuta las tareas periódicas vencidas (cada LORA_TIMEOUT segundos, envía un payload LoRa;
+          cada TIMEOUT_READ_SENSORS segundos, pide el refresco de los sensores),
+        - atiende los eventos pendientes (ver events.h y runPendingEvents()): mide corriente,
+          lluvia y combustible (salvo durante una alerta), inicia las alertas pedidas, procesa
+          los mensajes LoRa entrantes, ejecuta sus comandos y espera la posición del GPS,
+        - lee los caracteres recibidos del GPS,
         - observa el estado actual de las variables de programa y, de ser necesario, actúa:
-            - emite las alertas que sean necesarias,
-            - ejecuta comandos entrantes de LoRa.
-    Al finalizar el loop, resetea el watchdog timer.
+            - vuelve a poner al SX1278 en recepción luego de cada transmisión,
+            - duerme al SX1278 y al GPS cuando no se los necesita.
+    Al finalizar el loop, resetea el watchdog timer y duerme al MCU hasta que haya algo que hacer
+    (ver powerIdle()). Con PROFILER, cada bloque y la pasada completa se miden con una sonda
+    del perfilador (ver PROFILE()).
     Esta función se repite hasta que se le dé un reset al programa.
 */
 void loop() {
-    if (runEvery(sec2ms(LORA_TIMEOUT), 1)) {
-        // Deja de refrescar TODOS los sensores.
-        stopRefreshingAllSensors();
-
-        // Compone la carga útil de LoRa.
-        composeLoRaPayload(currents, raindrops, gas, outcomingFull);
-
-        #if DEBUG_LEVEL >= 1
-            Serial.print("Payload LoRa encolado!: ");
-            Serial.println(outcomingFull);
-        #endif
-
-        // Compone y envía el paquete LoRa.
-        LoRa.beginPacket();
-        LoRa.print(outcomingFull);
-        LoRa.endPacket();
-
-        // Pone al módulo LoRa en modo recepción.
-        LoRa.receive();
-
-        // Inicia la alerta preestablecida.
-        startAlert(133, 4);
-
-        // Reestablece los arrays de medición.
-        cleanupArray(currents, ARRAY_SIZE);
-        cleanupArray(raindrops, ARRAY_SIZE);
+    #if PROFILER
+        uint32_t passMicros = micros();
+    #endif
 
-        // Reestablece el index de los arrays de medición.
-        index = 0;
+    // Ejecuta las tareas periódicas vencidas (reporte LoRa, refresco de sensores y buzzer).
+    runDueTasks();
 
-        // Vuelve a pedir que se refresque el estado del nivel de combustible.
-        gasRequested = true;
-    }
+    // Ejecuta los manejadores de los eventos pendientes (mediciones, alertas, mensajes LoRa y GPS).
+    runPendingEvents();
 
-    if(runEvery(sec2ms(TIMEOUT_READ_SENSORS), 2)) {
-        // Refresca TODOS los sensores dependientes de refreshRequested.
-        refreshAllSensors();
-        // Avanza el índice de TODOS los arrays de medición.
-        index++;
-        // Vuelve a pedir que se refresque el estado del GPS.
-        GPSRequested = true;
+    {
+        PROFILE(PROBE_LORA);
+        LoRaTxObserver();
+        profileObserver();
     }
-
-    if (!resetAlert && !pitidosRestantes) {
-        if (refreshRequested[0]) {
-            // Obtiene un nuevo valor de corriente.
-            #ifndef CORRIENTE_MOCK
-                eMon.calcVI(EMON_CROSSINGS, EMON_TIMEOUT);
-            #endif
-            getNewCurrent();
-        }
-        if (refreshRequested[1]) {
-            // Obtiene un nuevo valor de lluvia.
-            getNewRaindrop();
-        }
-
-        if (gasRequested) {
-            // Obtiene un nuevo valor de combustible.
-            getNewGas();
-        }
-    }
-
-    alertObserver();
-    LoRaCmdObserver();
     getNewGPS();
-
-    #if DEBUG_LEVEL >= 2
-        // scanTime();
-    #endif
+    powerObserver();
 
     #if USE_WATCHDOG_TMR == TRUE
         wdt_reset();
     #endif
+
+    #if PROFILER
+        profileRecord(profile[PROBE_LOOP], micros() - passMicros);
+    #endif
+    powerIdle();
 }
@@ -0,0 +1,411 @@
+/**
+    Micro-benchmarks en el host de las funciones del nodo que se ejecutan en cada reporte,
+    en cada medición o en cada carácter/muestra recibidos:
+        - composeLoRaPayload():  carga útil ASCII de una ventana (op = un payload),
+        - composeBinaryPayload(): carga útil binaria de una ventana (op = un payload),
+        - statsAdd():            acumulador de corriente de la ventana (op = un valor),
+        - votesAdd():            votación de lluvia de la ventana (op = un voto),
+        - round2decimals():      redondeo de los valores reportados (op = un valor),
+        - encode(char):          TinyGPSPlus de a un carácter (op = un carácter),
+        - encode(chunk):         TinyGPSPlus de a bloques de GPS_CHUNK_SIZE (op = un carácter),
+        - parseDegrees():        conversión de la latitud/longitud NMEA (op = un término),
+        - pollVI():              medición de corriente de EmonLib, como getNewCurrent() (op = una muestra),
+        - calcIrms():            ídem, bloqueante y sin detección de semi-ondas (op = una muestra).
+    statsAdd() y votesAdd() reemplazan a las dos sobrecargas de compressArray() (float e int),
+    que reducían el array de mediciones de la ventana al momento de reportar.
+    Las entradas son fijas (tablas generadas con un LCG de semilla constante, un segundo de
+    salida NMEA de un NEO-6M y una senoidal de 50 Hz a ADC_SAMPLE_RATE / ADC_CHANNELS_QTY), por lo
+    que, con el mismo factor, el checksum de cada benchmark es el mismo en todas las ejecuciones
+    (con -O0 o -O2): si cambia, cambió el resultado de la función y no sólo su tiempo.
+    Por cada benchmark se informan los ns por operación y las asignaciones de memoria
+    (malloc(), calloc() y realloc(), incluidas las de new y de String) por operación;
+    el conteo de asignaciones requiere glibc (en otro caso se informa "-").
+        $ ./micro_bench [factor]
+    factor multiplica la cantidad de operaciones de cada benchmark (1 por defecto).
+    Compilación (desde la raíz del repositorio, con la configuración de constants.h):
+        g++ -std=gnu++11 -O2 -DARDUINO=10813 -DARDUINO_NATIVE -DNATIVE_CUSTOM_MAIN
+            -Iinclude -Isrc -Ilib/ArduinoNative/src -Ilib/LoRa/src -Ilib/EmonLib-master
+            -Ilib/TinyGPSPlus-master/src -Ilib/StringReserveCheck/src
+            tools/micro_bench/micro_bench.cpp lib/ArduinoNative/src/[A-Za-z]*.cpp lib/LoRa/src/LoRa.cpp
+            lib/EmonLib-master/EmonLib.cpp lib/TinyGPSPlus-master/src/TinyGPS++.cpp
+            lib/StringReserveCheck/src/StringReserveCheck.cpp -o micro_bench
+    @file micro_bench.cpp
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+#include "main.cpp"
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#define BENCH_SEED 20009UL          // Semilla del LCG de las entradas.
+#define BENCH_TABLE_SIZE 1024       // Cantidad de valores de cada tabla de entradas (potencia de 2).
+#define BENCH_CT_FREQ 50            // Frecuencia de la corriente simulada (en Hz).
+#define BENCH_CT_AMPLITUDE 200      // Amplitud de la corriente simulada (en cuentas del ADC).
+#define BENCH_WARMUP_DIVISOR 10     // Fracción de las operaciones que se ejecutan antes de medir.
+
+/**
+    Conteo de asignaciones: con glibc, malloc(), calloc() y realloc() se reemplazan por versiones
+    que cuentan cada llamada y delegan en las de glibc (new y String terminan en ellas).
+*/
+static unsigned long benchAllocations = 0;
+
+#ifdef __GLIBC__
+    #define BENCH_COUNTS_ALLOCATIONS true
+
+    extern "C" void *__libc_malloc(size_t size);
+    extern "C" void *__libc_calloc(size_t count, size_t size);
+    extern "C" void *__libc_realloc(void *pointer, size_t size);
+
+    extern "C" void *malloc(size_t size) __THROW {
+        benchAllocations++;
+        return __libc_malloc(size);
+    }
+
+    extern "C" void *calloc(size_t count, size_t size) __THROW {
+        benchAllocations++;
+        return __libc_calloc(count, size);
+    }
+
+    extern "C" void *realloc(void *pointer, size_t size) __THROW {
+        benchAllocations++;
+        return __libc_realloc(pointer, size);
+    }
+#else
+    #define BENCH_COUNTS_ALLOCATIONS false
+#endif
+
+static uint32_t benchState = BENCH_SEED;
+
+/**
+    benchRandom() obtiene el siguiente valor del LCG de las entradas (el de Numerical Recipes).
+    @return Valor pseudoaleatorio de 32 bits.
+*/
+static uint32_t benchRandom() {
+    benchState = benchState * 1664525UL + 1013904223UL;
+    return benchState;
+}
+
+/**
+    benchUniform() obtiene un valor pseudoaleatorio en un rango.
+    @param min Mínimo.
+    @param max Máximo.
+    @return Valor entre min y max.
+*/
+static float benchUniform(float min, float max) {
+    return min + (max - min) * (benchRandom() >> 8) / 16777216.0;
+}
+
+/**
+    benchHash() acumula un valor en un checksum (FNV-1a).
+    @param hash Checksum acumulado.
+    @param data Dirección de memoria del valor.
+    @param size Tamaño del valor (en bytes).
+    @return Checksum actualizado.
+*/
+static uint32_t benchHash(uint32_t hash, const void *data, size_t size) {
+    const uint8_t *bytes = (const uint8_t *)data;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 16777619UL;
+    }
+    return hash;
+}
+
+/**
+    BenchSink es un Print que escribe sobre un buffer fijo (como el FIFO del SX1278).
+*/
+class BenchSink : public Print {
+    public:
+        uint8_t buffer[256];
+        size_t length;
+
+        BenchSink() : length(0) {}
+
+        size_t write(uint8_t c) {
+            if (length >= sizeof(buffer)) {
+                return 0;
+            }
+            buffer[length++] = c;
+            return 1;
+        }
+};
+
+/**
+    Entradas de los benchmarks (ver benchInputs()).
+*/
+struct BenchWindow {
+    WindowCurrent current;
+    int raindrop;
+    float gas;
+};
+
+static BenchWindow benchWindows[BENCH_TABLE_SIZE];
+static float benchValues[BENCH_TABLE_SIZE];
+static int benchSamples[BENCH_TABLE_SIZE];
+static const char *benchTerms[] = {
+    "3434.48495", "05826.13100", "3449.85000", "00000.00001", "8959.99999", "17959.99999",
+    "3434.4849512", "0000.0000", "05826.1", "4124.8963", "08151.6838", "3"
+};
+#define BENCH_TERMS_QTY (sizeof(benchTerms) / sizeof(benchTerms[0]))
+static std::string benchNmea;
+static unsigned int benchSampleIndex = 0;
+
+/**
+    appendSentence() agrega una sentencia NMEA al corpus, con su checksum y su fin de línea.
+    @param &corpus Corpus.
+    @param body Sentencia sin '$', '*' ni checksum.
+*/
+static void appendSentence(std::string &corpus, const char *body) {
+    uint8_t parity = 0;
+    for (const char *p = body; *p; p++) {
+        parity ^= (uint8_t)*p;
+    }
+    char tail[8];
+    snprintf(tail, sizeof(tail), "*%02X\r\n", parity);
+    corpus += '$';
+    corpus += body;
+    corpus += tail;
+}
+
+/**
+    benchInputs() genera las tablas de entradas, siempre las mismas: ventanas de medición con
+    corrientes de 0 a 60 A, valores a redondear, una senoidal de corriente y un segundo de
+    salida de un NEO-6M (RMC, VTG, GGA, GSA, 3 GSV y GLL). Además, le da al GPS del firmware
+    una posición válida, para que composeLoRaPayload() la incluya.
+*/
+static void benchInputs() {
+    benchState = BENCH_SEED;
+    for (int i = 0; i < BENCH_TABLE_SIZE; i++) {
+        BenchWindow &window = benchWindows[i];
+        RunningStats stats;
+        statsReset(stats);
+        float level = benchUniform(0.0, 60.0);
+        for (int n = 0; n < 20; n++) {
+            statsAdd(stats, level + benchUniform(-0.5, 0.5));
+        }
+        window.current = reduceCurrent(stats);
+        window.raindrop = (int)(benchRandom() % 3) - 1;
+        window.gas = benchUniform(0.0, 12.0);
+        benchValues[i] = benchUniform(-1000.0, 1000.0);
+    }
+
+    const double samplesPerCycle = (double)ADC_SAMPLE_RATE / ADC_CHANNELS_QTY / BENCH_CT_FREQ;
+    for (int i = 0; i < BENCH_TABLE_SIZE; i++) {
+        benchSamples[i] = 512 + lround(BENCH_CT_AMPLITUDE * sin(2 * M_PI * i / samplesPerCycle)) +
+            (int)(benchRandom() % 5) - 2;
+    }
+
+    benchNmea.clear();
+    appendSentence(benchNmea, "GPRMC,120000.00,A,3434.48495,S,05826.13100,W,0.512,,161026,,,A");
+    appendSentence(benchNmea, "GPVTG,,T,,M,0.512,N,0.948,K,A");
+    appendSentence(benchNmea, "GPGGA,120000.00,3434.48495,S,05826.13100,W,1,08,1.01,15.3,M,16.9,M,,");
+    appendSentence(benchNmea, "GPGSA,A,3,12,25,29,02,05,31,20,26,,,,,2.02,1.01,1.75");
+    appendSentence(benchNmea, "GPGSV,3,1,12,02,41,101,35,05,37,063,38,12,68,231,41,13,06,124,");
+    appendSentence(benchNmea, "GPGSV,3,2,12,20,27,297,33,21,03,244,,25,62,012,44,26,11,323,29");
+    appendSentence(benchNmea, "GPGSV,3,3,12,29,44,167,40,31,22,250,36,46,31,288,,48,31,291,");
+    appendSentence(benchNmea, "GPGLL,3434.48495,S,05826.13100,W,120000.00,A,A");
+
+    GPS.encode(benchNmea.data(), benchNmea.size());
+}
+
+/**
+    Cada benchmark ejecuta ops operaciones y devuelve un checksum de sus resultados.
+*/
+typedef uint32_t (*BenchFunction)(unsigned long ops);
+
+static uint32_t benchComposeAscii(unsigned long ops) {
+    uint32_t hash = 0;
+    BenchSink sink;
+    for (unsigned long i = 0; i < ops; i++) {
+        const BenchWindow &window = benchWindows[i & (BENCH_TABLE_SIZE - 1)];
+        sink.length = 0;
+        composeLoRaPayload(window.current, window.raindrop, window.gas, sink);
+        hash = benchHash(hash, sink.buffer, sink.length);
+    }
+    return hash;
+}
+
+static uint32_t benchComposeBinary(unsigned long ops) {
+    uint32_t hash = 0;
+    uint8_t payload[BINARY_PAYLOAD_STATS_SIZE];
+    for (unsigned long i = 0; i < ops; i++) {
+        const BenchWindow &window = benchWindows[i & (BENCH_TABLE_SIZE - 1)];
+        size_t length = composeBinaryPayload(window.current, window.raindrop, window.gas, payload);
+        hash = benchHash(hash, payload, length);
+    }
+    return hash;
+}
+
+static uint32_t benchStats(unsigned long ops) {
+    RunningStats stats;
+    statsReset(stats);
+    for (unsigned long i = 0; i < ops; i++) {
+        statsAdd(stats, benchValues[i & (BENCH_TABLE_SIZE - 1)]);
+    }
+    float results[] = {statsMean(stats), statsMin(stats), statsMax(stats), statsStddev(stats)};
+    return benchHash(0, results, sizeof(results));
+}
+
+static uint32_t benchVotes(unsigned long ops) {
+    VoteCounter votes;
+    votesReset(votes);
+    uint32_t hash = 0;
+    for (unsigned long i = 0; i < ops; i++) {
+        votesAdd(votes, benchValues[i & (BENCH_TABLE_SIZE - 1)] > 0);
+        if ((i & (BENCH_TABLE_SIZE - 1)) == BENCH_TABLE_SIZE - 1) {
+            int result = votesResult(votes);
+            hash = benchHash(hash, &result, sizeof(result));
+            votesReset(votes);
+        }
+    }
+    return hash;
+}
+
+static uint32_t benchRound(unsigned long ops) {
+    uint32_t hash = 0;
+    for (unsigned long i = 0; i < ops; i++) {
+        float rounded = round2decimals(benchValues[i & (BENCH_TABLE_SIZE - 1)]);
+        hash = benchHash(hash, &rounded, sizeof(rounded));
+    }
+    return hash;
+}
+
+static uint32_t benchEncodeChar(unsigned long ops) {
+    TinyGPSPlus gps;
+    const char *data = benchNmea.data();
+    size_t size = benchNmea.size();
+    for (unsigned long i = 0; i < ops; i++) {
+        gps.encode(data[i % size]);
+    }
+    uint32_t results[] = {gps.passedChecksum(), gps.failedChecksum(), gps.sentencesWithFix(),
+        (uint32_t)gps.location.rawLat().billionths, (uint32_t)gps.altitude.value()};
+    return benchHash(0, results, sizeof(results));
+}
+
+static uint32_t benchEncodeChunk(unsigned long ops) {
+    TinyGPSPlus gps;
+    const char *data = benchNmea.data();
+    size_t size = benchNmea.size();
+    for (unsigned long done = 0; done < ops;) {
+        size_t offset = done % size;
+        size_t length = size - offset < GPS_CHUNK_SIZE ? size - offset : GPS_CHUNK_SIZE;
+        if (length > ops - done) {
+            length = ops - done;
+        }
+        gps.encode(data + offset, length);
+        done += length;
+    }
+    uint32_t results[] = {gps.passedChecksum(), gps.failedChecksum(), gps.sentencesWithFix(),
+        (uint32_t)gps.location.rawLat().billionths, (uint32_t)gps.altitude.value()};
+    return benchHash(0, results, sizeof(results));
+}
+
+static uint32_t benchParseDegrees(unsigned long ops) {
+    uint32_t hash = 0;
+    RawDegrees degrees;
+    for (unsigned long i = 0; i < ops; i++) {
+        TinyGPSPlus::parseDegrees(benchTerms[i % BENCH_TERMS_QTY], degrees);
+        hash = benchHash(hash, &degrees.deg, sizeof(degrees.deg));
+        hash = benchHash(hash, &degrees.billionths, sizeof(degrees.billionths));
+    }
+    return hash;
+}
+
+/**
+    benchSample() entrega la siguiente muestra de la senoidal de corriente (ver EmonSampleReader).
+*/
+static boolean benchSample(unsigned int pin, int &sample) {
+    (void)pin;
+    sample = benchSamples[benchSampleIndex++ & (BENCH_TABLE_SIZE - 1)];
+    return true;
+}
+
+/**
+    benchVcc() entrega una tensión de alimentación fija (ver EmonVccReader).
+*/
+static long benchVcc() {
+    return 5000;
+}
+
+static uint32_t benchPollVI(unsigned long ops) {
+    EnergyMonitor emon;
+    emon.current(CORRIENTE_PIN, EMON_CALIBRATION);
+    emon.sampleReader(benchSample, benchVcc);
+    benchSampleIndex = 0;
+    uint32_t hash = 0;
+    while (benchSampleIndex < ops) {
+        emon.beginI(EMON_CROSSINGS, EMON_TIMEOUT);
+        while (!emon.pollVI(EMON_SAMPLES_PER_LOOP)) {}
+        hash = benchHash(hash, &emon.Irms, sizeof(emon.Irms));
+    }
+    return hash;
+}
+
+static uint32_t benchCalcIrms(unsigned long ops) {
+    EnergyMonitor emon;
+    emon.current(CORRIENTE_PIN, EMON_CALIBRATION);
+    emon.sampleReader(benchSample, benchVcc);
+    benchSampleIndex = 0;
+    double irms = emon.calcIrms(ops);
+    return benchHash(0, &irms, sizeof(irms));
+}
+
+/**
+    Bench contiene un benchmark: su nombre, su función y su cantidad de operaciones.
+*/
+struct Bench {
+    const char *name;
+    BenchFunction function;
+    unsigned long ops;
+};
+
+static const Bench benches[] = {
+    {"composeLoRaPayload", benchComposeAscii, 200000UL},
+    {"composeBinaryPayload", benchComposeBinary, 2000000UL},
+    {"statsAdd", benchStats, 20000000UL},
+    {"votesAdd", benchVotes, 20000000UL},
+    {"round2decimals", benchRound, 20000000UL},
+    {"encode(char)", benchEncodeChar, 20000000UL},
+    {"encode(chunk)", benchEncodeChunk, 20000000UL},
+    {"parseDegrees", benchParseDegrees, 5000000UL},
+    {"pollVI", benchPollVI, 20000000UL},
+    {"calcIrms", benchCalcIrms, 20000000UL},
+};
+#define BENCHES_QTY (sizeof(benches) / sizeof(benches[0]))
+
+int main(int argc, char **argv) {
+    unsigned long factor = argc > 1 ? strtoul(argv[1], NULL, 10) : 1;
+    if (factor == 0) {
+        fprintf(stderr, "Factor inválido\n");
+        return 1;
+    }
+
+    benchInputs();
+    printf("%-22s %12s %10s %12s %10s\n", "benchmark", "ops", "ns/op", "allocs/op", "checksum");
+    for (size_t b = 0; b < BENCHES_QTY; b++) {
+        unsigned long ops = benches[b].ops * factor;
+        benches[b].function(ops / BENCH_WARMUP_DIVISOR);
+
+        unsigned long allocations = benchAllocations;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        uint32_t checksum = benches[b].function(ops);
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        allocations = benchAllocations - allocations;
+
+        char allocationsPerOp[16];
+        if (BENCH_COUNTS_ALLOCATIONS) {
+            snprintf(allocationsPerOp, sizeof(allocationsPerOp), "%.3f", (double)allocations / ops);
+        } else {
+            snprintf(allocationsPerOp, sizeof(allocationsPerOp), "-");
+        }
+        printf("%-22s %12lu %10.2f %12s   %08lx\n", benches[b].name, ops, elapsed.count() / ops,
+            allocationsPerOp, (unsigned long)checksum);
+    }
+    return 0;
+}
@@ -0,0 +1,195 @@
+/**
+    Benchmark de TinyGPSPlus en el host: reproduce un corpus NMEA varias veces y reporta
+    cuántos bytes por segundo procesa cada forma de encodear:
+        - char:        encode(char) de a un carácter, como lo hacía getNewGPS(),
+        - char+filter: ídem, con el filtro de sentencias (sentenceFilter(true)),
+        - chunk:       encode(const char*, size_t) de a bloques de GPS_CHUNK_SIZE caracteres,
+        - chunk+filter: ídem, con el filtro de sentencias (lo que hace getNewGPS()).
+    También verifica que las cuatro formas obtengan la misma posición, hora y altitud.
+    El corpus se lee del archivo indicado como argumento (por ejemplo, una captura del puerto
+    serie del GPS); si no se indica ninguno, se genera uno sintético con la salida de un NEO-6M
+    a 1 Hz (RMC, VTG, GGA, GSA, 3 GSV y GLL por segundo), con checksums válidos:
+        $ ./nmea_bench [corpus.nmea] [repeticiones]
+    Compilación (desde la raíz del repositorio):
+        g++ -std=gnu++11 -O2 -DARDUINO=10813 -DARDUINO_NATIVE -DNATIVE_CUSTOM_MAIN
+            -Iinclude -Ilib/ArduinoNative/src -Ilib/TinyGPSPlus-master/src
+            tools/nmea_bench/nmea_bench.cpp lib/TinyGPSPlus-master/src/TinyGPS++.cpp
+            lib/ArduinoNative/src/NativeHardware.cpp -o nmea_bench
+    @file nmea_bench.cpp
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+#include <TinyGPS++.h>
+
+#include "constants.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#define SYNTHETIC_SECONDS 600   // Segundos de salida del GPS en el corpus sintético.
+#define DEFAULT_REPETITIONS 200 // Cantidad de veces que se reproduce el corpus en cada forma.
+
+/**
+    appendSentence() agrega una sentencia NMEA al corpus, con su checksum y su fin de línea.
+    @param &corpus Corpus.
+    @param body Sentencia sin '$', '*' ni checksum.
+*/
+static void appendSentence(std::string &corpus, const char *body) {
+    uint8_t parity = 0;
+    for (const char *p = body; *p; p++) {
+        parity ^= (uint8_t)*p;
+    }
+    char tail[8];
+    snprintf(tail, sizeof(tail), "*%02X\r\n", parity);
+    corpus += '$';
+    corpus += body;
+    corpus += tail;
+}
+
+/**
+    syntheticCorpus() genera la salida de un NEO-6M a 1 Hz durante una cantidad de segundos,
+    con la posición avanzando lentamente (para que cada GGA/RMC cambie algún término).
+    @param seconds Cantidad de segundos.
+    @return Corpus.
+*/
+static std::string syntheticCorpus(unsigned int seconds) {
+    std::string corpus;
+    char body[100];
+    for (unsigned int s = 0; s < seconds; s++) {
+        unsigned int hh = 12 + s / 3600, mm = (s / 60) % 60, ss = s % 60;
+        unsigned long minutes = 498500UL + s;  // 34°49.8500' (en diezmilésimos de minuto).
+        snprintf(body, sizeof(body), "GPRMC,%02u%02u%02u.00,A,34%02lu.%04lu,S,05826.13100,W,0.512,,161026,,,A",
+            hh, mm, ss, minutes / 10000 % 100, minutes % 10000);
+        appendSentence(corpus, body);
+        appendSentence(corpus, "GPVTG,,T,,M,0.512,N,0.948,K,A");
+        snprintf(body, sizeof(body), "GPGGA,%02u%02u%02u.00,34%02lu.%04lu,S,05826.13100,W,1,08,1.01,15.3,M,16.9,M,,",
+            hh, mm, ss, minutes / 10000 % 100, minutes % 10000);
+        appendSentence(corpus, body);
+        appendSentence(corpus, "GPGSA,A,3,12,25,29,02,05,31,20,26,,,,,2.02,1.01,1.75");
+        appendSentence(corpus, "GPGSV,3,1,12,02,41,101,35,05,37,063,38,12,68,231,41,13,06,124,");
+        appendSentence(corpus, "GPGSV,3,2,12,20,27,297,33,21,03,244,,25,62,012,44,26,11,323,29");
+        appendSentence(corpus, "GPGSV,3,3,12,29,44,167,40,31,22,250,36,46,31,288,,48,31,291,");
+        snprintf(body, sizeof(body), "GPGLL,34%02lu.%04lu,S,05826.13100,W,%02u%02u%02u.00,A,A",
+            minutes / 10000 % 100, minutes % 10000, hh, mm, ss);
+        appendSentence(corpus, body);
+    }
+    return corpus;
+}
+
+/**
+    readCorpus() lee un corpus desde un archivo.
+    @param path Ruta del archivo.
+    @param &corpus Corpus.
+    @return true si se pudo leer, false en caso contrario.
+*/
+static bool readCorpus(const char *path, std::string &corpus) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return false;
+    }
+    char buffer[4096];
+    size_t length;
+    while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        corpus.append(buffer, length);
+    }
+    fclose(file);
+    return true;
+}
+
+/**
+    Result contiene lo que obtuvo una forma de encodear, para compararla con las demás.
+*/
+struct Result {
+    double bytesPerSecond;
+    uint32_t passed, failed, skipped, withFix;
+    double lat, lng, alt;
+    uint32_t time;
+};
+
+/**
+    run() reproduce el corpus con un objeto TinyGPSPlus nuevo y mide cuánto tarda.
+    @param corpus Corpus.
+    @param repetitions Cantidad de veces que se reproduce.
+    @param chunked true para encode(const char*, size_t), false para encode(char).
+    @param filter Estado del filtro de sentencias.
+    @return Resultado.
+*/
+static Result run(const std::string &corpus, unsigned int repetitions, bool chunked, bool filter) {
+    TinyGPSPlus gps;
+    gps.sentenceFilter(filter);
+    const char *data = corpus.data();
+    size_t size = corpus.size();
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned int r = 0; r < repetitions; r++) {
+        if (chunked) {
+            for (size_t i = 0; i < size; i += GPS_CHUNK_SIZE) {
+                gps.encode(data + i, size - i < GPS_CHUNK_SIZE ? size - i : GPS_CHUNK_SIZE);
+            }
+        } else {
+            for (size_t i = 0; i < size; i++) {
+                gps.encode(data[i]);
+            }
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    Result result;
+    result.bytesPerSecond = (double)size * repetitions / elapsed.count();
+    result.passed = gps.passedChecksum();
+    result.failed = gps.failedChecksum();
+    result.skipped = gps.sentencesSkipped();
+    result.withFix = gps.sentencesWithFix();
+    result.lat = gps.location.lat();
+    result.lng = gps.location.lng();
+    result.alt = gps.altitude.meters();
+    result.time = gps.time.value();
+    return result;
+}
+
+int main(int argc, char **argv) {
+    std::string corpus;
+    if (argc > 1 && strcmp(argv[1], "-") != 0) {
+        if (!readCorpus(argv[1], corpus)) {
+            fprintf(stderr, "No se pudo leer %s\n", argv[1]);
+            return 1;
+        }
+    } else {
+        corpus = syntheticCorpus(SYNTHETIC_SECONDS);
+    }
+    unsigned int repetitions = argc > 2 ? strtoul(argv[2], NULL, 10) : DEFAULT_REPETITIONS;
+    if (corpus.empty() || repetitions == 0) {
+        fprintf(stderr, "Corpus vacío o cantidad de repeticiones inválida\n");
+        return 1;
+    }
+    printf("Corpus: %zu bytes, %u repeticiones\n", corpus.size(), repetitions);
+
+    const char *names[] = {"char", "char+filter", "chunk", "chunk+filter"};
+    Result results[4];
+    for (int i = 0; i < 4; i++) {
+        results[i] = run(corpus, repetitions, i >= 2, i % 2);
+        printf("%-13s %8.2f MB/s  passed=%lu failed=%lu skipped=%lu fix=%lu\n", names[i],
+            results[i].bytesPerSecond / 1e6, (unsigned long)results[i].passed,
+            (unsigned long)results[i].failed, (unsigned long)results[i].skipped,
+            (unsigned long)results[i].withFix);
+    }
+    printf("Posición: %.6f, %.6f, alt %.2f m, hora %08lu\n", results[0].lat, results[0].lng,
+        results[0].alt, (unsigned long)results[0].time);
+
+    bool same = true;
+    for (int i = 1; i < 4; i++) {
+        same = same && results[i].lat == results[0].lat && results[i].lng == results[0].lng &&
+            results[i].alt == results[0].alt && results[i].time == results[0].time &&
+            results[i].withFix == results[0].withFix;
+    }
+    if (!same) {
+        printf("ERROR: las formas de encodear no obtuvieron los mismos datos\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,592 @@
+/**
+    Simulador del nodo en el host: ejecuta el firmware completo (setup() y loop() de main.cpp,
+    con la configuración de constants.h) sobre los modelos de ArduinoNative, siguiendo un
+    escenario que indica, en cada instante, las entradas de los sensores, la salida del GPS
+    y los paquetes que recibe el SX1278, y verificando los paquetes que transmite el nodo.
+    Para simular semanas en segundos, el reloj virtual salta entre pasadas de loop() cuando
+    el firmware no tiene nada que hacer hasta el próximo evento (una tarea del planificador,
+    una interrupción de un modelo, una línea del escenario o un vencimiento de power.h),
+    como lo haría powerDown(): los modelos "de fondo" (el motor del ADC) se saltean y sólo
+    se ejecutan mientras haya una medición de corriente en curso (ver nativeSkipTo()).
+    El tiempo salteado cuenta como SLEEP_MODE_IDLE en la estimación de energía.
+    millis() arranca una hora antes de desbordar (y micros() desborda cada 71,6 minutos, como en
+    el ATmega328), por lo que los escenarios de más de una hora también verifican los desbordes.
+    Uso:
+        $ ./node_sim escenario.sim [-q] [-v]
+    -q no lista los paquetes transmitidos, -v muestra la salida del firmware por puerto serial.
+    Devuelve 0 si se cumplieron todas las verificaciones del escenario, o 1 si no.
+    Cada línea del escenario es "<instante> <comando> [argumentos]" ('#' inicia un comentario).
+    El instante es un número con unidad opcional (s, m, h o d; por ejemplo 90, 1.5m o 1d12h).
+    Los comandos son:
+        ct <A>                     corriente: 512 + A * sen(2 * pi * 50 * t) en CORRIENTE_PIN,
+        rain <valor>               lectura del ADC en LLUVIA_PIN,
+        echo <us>                  duración del eco del sensor de combustible,
+        gps <lat> <lng> <alt>      el GPS envía RMC y GGA con esa posición, una vez por segundo,
+        gps nofix / gps off        el GPS envía RMC y GGA sin posición / no envía nada,
+        downlink <texto>           el SX1278 recibe un paquete con ese texto,
+        expect count <n> [<max>]   se transmitieron n paquetes (o entre n y max) hasta ahora,
+        expect last <texto>        el último paquete transmitido contiene el texto,
+        expect interval <ms> <tol> los paquetes transmitidos desde el "expect interval" anterior
+                                   están separados ms +/- tol,
+        end                        fin de la simulación (si no está, termina en la última línea).
+    Compilación (desde la raíz del repositorio):
+        g++ -std=gnu++11 -O2 -DARDUINO=10813 -DARDUINO_NATIVE -DNATIVE_CUSTOM_MAIN
+            -Iinclude -Isrc -Ilib/ArduinoNative/src -Ilib/LoRa/src -Ilib/EmonLib-master
+            -Ilib/TinyGPSPlus-master/src -Ilib/StringReserveCheck/src
+            tools/node_sim/node_sim.cpp lib/ArduinoNative/src/[A-Za-z]*.cpp lib/LoRa/src/LoRa.cpp
+            lib/EmonLib-master/EmonLib.cpp lib/TinyGPSPlus-master/src/TinyGPS++.cpp
+            lib/StringReserveCheck/src/StringReserveCheck.cpp -o node_sim
+    @file node_sim.cpp
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.0 16/10/2026
+*/
+
+#include "main.cpp"
+
+#include <NativeHardware.h>
+#include <NativeSX1278.h>
+
+#include <chrono>
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#define SIM_LOOP_COST_NS 20000ULL         // Overhead propio de una pasada de loop() (en ns, como native_main.cpp).
+#define SIM_MAX_SKIP_NS 1000000000ULL     // Salto máximo del reloj, para que loop() siga alimentando al watchdog.
+#define SIM_GPS_OFFSET_NS 500000000ULL    // Desfase de la salida del GPS respecto de cada segundo.
+#define SIM_MILLIS_START (0x100000000ULL - 3600000ULL) // millis() al arrancar: desborda a la hora.
+
+/**
+    SimLine contiene una línea del escenario.
+*/
+struct SimLine {
+    unsigned long long ns;  // Instante.
+    int number;             // Número de línea en el archivo.
+    std::string command;
+    std::string args;
+};
+
+/**
+    SimPacket contiene un paquete transmitido por el nodo.
+*/
+struct SimPacket {
+    unsigned long long ms;  // Instante en que empezó la transmisión.
+    std::string text;       // Payload (en hexadecimal si no es ASCII).
+};
+
+static std::vector<SimLine> simLines;
+static std::vector<SimPacket> simPackets;
+static size_t simIntervalFrom = 0;  // Primer paquete del próximo "expect interval".
+static int simErrors = 0;
+static bool simQuiet = false;
+static unsigned long long simEnd = 0;
+
+static int simCtPeak = 0;           // Amplitud de la corriente (en cuentas del ADC).
+static bool simGpsOn = false;
+static bool simGpsFix = false;
+static double simLat = 0, simLng = 0, simAlt = 0;
+
+/**
+    simError() informa una verificación fallida.
+*/
+static void simError(const SimLine &line, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    fprintf(stderr, "ERROR línea %d (t=%llu ms): ", line.number, line.ns / 1000000ULL);
+    vfprintf(stderr, format, args);
+    fputc('\n', stderr);
+    va_end(args);
+    simErrors++;
+}
+
+/**
+    simParseTime() convierte un instante del escenario (por ejemplo 90, 1.5m o 1d12h) a ns.
+    @return true si el instante es válido.
+*/
+static bool simParseTime(const char *text, unsigned long long &ns) {
+    double total = 0;
+    const char *p = text;
+    do {
+        char *end;
+        double value = strtod(p, &end);
+        if (end == p || value < 0) {
+            return false;
+        }
+        double unit = 1;
+        switch (*end) {
+            case 'd': unit = 86400; end++; break;
+            case 'h': unit = 3600; end++; break;
+            case 'm': unit = 60; end++; break;
+            case 's': end++; break;
+            case '\0': break;
+            default: return false;
+        }
+        total += value * unit;
+        p = end;
+    } while (*p);
+    ns = (unsigned long long)(total * 1e9 + 0.5);
+    return true;
+}
+
+/**
+    simLoad() lee el escenario, ordenado por instante.
+    @return true si todas las líneas son válidas.
+*/
+static bool simLoad(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "No se pudo abrir %s\n", path);
+        return false;
+    }
+    char buffer[512];
+    int number = 0;
+    bool ok = true;
+    while (fgets(buffer, sizeof(buffer), file)) {
+        number++;
+        buffer[strcspn(buffer, "#\r\n")] = 0;
+        char time[32], command[32];
+        int consumed = 0;
+        if (sscanf(buffer, " %31s %31s %n", time, command, &consumed) < 2) {
+            if (sscanf(buffer, " %31s", time) == 1) {
+                fprintf(stderr, "%s:%d: falta el comando\n", path, number);
+                ok = false;
+            }
+            continue;
+        }
+        SimLine line;
+        line.number = number;
+        line.command = command;
+        line.args = buffer + consumed;
+        line.args.erase(line.args.find_last_not_of(" \t") + 1);
+        if (!simParseTime(time, line.ns)) {
+            fprintf(stderr, "%s:%d: instante inválido: %s\n", path, number, time);
+            ok = false;
+            continue;
+        }
+        size_t i = simLines.size();
+        while (i > 0 && simLines[i - 1].ns > line.ns) {
+            i--;
+        }
+        simLines.insert(simLines.begin() + i, line);
+    }
+    fclose(file);
+    return ok;
+}
+
+/**
+    simCurrent() es la fuente analógica de CORRIENTE_PIN: una senoidal de 50 Hz centrada en 512.
+*/
+static int simCurrent(uint8_t pin, unsigned long long us) {
+    (void)pin;
+    return 512 + (int)lround(simCtPeak * sin(2 * M_PI * 50 * (us % 20000) / 1e6));
+}
+
+/**
+    simSentence() agrega una sentencia NMEA a un bloque, con su checksum y su fin de línea.
+*/
+static void simSentence(std::string &block, const char *body) {
+    uint8_t parity = 0;
+    for (const char *p = body; *p; p++) {
+        parity ^= (uint8_t)*p;
+    }
+    char tail[8];
+    snprintf(tail, sizeof(tail), "*%02X\r\n", parity);
+    block += '$';
+    block += body;
+    block += tail;
+}
+
+/**
+    simNmeaDegrees() escribe una coordenada como la escribe un GPS (grados y minutos, ddmm.mmmm).
+*/
+static void simNmeaDegrees(char *buffer, size_t size, double degrees, int width, char positive, char negative) {
+    double absolute = fabs(degrees);
+    int whole = (int)absolute;
+    snprintf(buffer, size, "%0*d%07.4f,%c", width, whole, (absolute - whole) * 60, degrees < 0 ? negative : positive);
+}
+
+/**
+    SimGps es el modelo del GPS: una vez por segundo envía RMC y GGA (salvo en modo backup).
+*/
+class SimGps : public NativeTicker {
+public:
+    SimGps() : _next(SIM_GPS_OFFSET_NS) {}
+
+    virtual unsigned long long nextEvent() { return _next; }
+
+    virtual void onEvent(unsigned long long now) {
+        (void)now;
+        unsigned long seconds = (unsigned long)(_next / 1000000000ULL);
+        _next += 1000000000ULL;
+        if (!simGpsOn || gpsAsleep) {
+            return;
+        }
+        char time[16], lat[24], lng[24], body[128];
+        snprintf(time, sizeof(time), "%02lu%02lu%02lu.00", seconds / 3600 % 24, seconds / 60 % 60, seconds % 60);
+        std::string block;
+        if (simGpsFix) {
+            simNmeaDegrees(lat, sizeof(lat), simLat, 2, 'N', 'S');
+            simNmeaDegrees(lng, sizeof(lng), simLng, 3, 'E', 'W');
+            snprintf(body, sizeof(body), "GPRMC,%s,A,%s,%s,0.0,,161026,,,A", time, lat, lng);
+            simSentence(block, body);
+            snprintf(body, sizeof(body), "GPGGA,%s,%s,%s,1,08,1.0,%.1f,M,16.9,M,,", time, lat, lng, simAlt);
+            simSentence(block, body);
+        } else {
+            snprintf(body, sizeof(body), "GPRMC,%s,V,,,,,,,161026,,,N", time);
+            simSentence(block, body);
+            snprintf(body, sizeof(body), "GPGGA,%s,,,,,0,00,99.99,,,,,,", time);
+            simSentence(block, body);
+        }
+        #if GPS_UART == GPS_UART_CAPTURE
+            GPSWire.feed(block.data(), block.size());
+        #else
+            ssGPS.feed(block.data(), block.size());
+        #endif
+    }
+
+private:
+    unsigned long long _next;
+};
+
+/**
+    simExpect() ejecuta una verificación del escenario.
+*/
+static void simExpect(const SimLine &line) {
+    char kind[16];
+    int consumed = 0;
+    if (sscanf(line.args.c_str(), "%15s %n", kind, &consumed) < 1) {
+        simError(line, "expect sin verificación");
+        return;
+    }
+    const char *args = line.args.c_str() + consumed;
+    unsigned long count = simPackets.size();
+    if (strcmp(kind, "count") == 0) {
+        unsigned long min = 0, max = 0;
+        int read = sscanf(args, "%lu %lu", &min, &max);
+        if (read < 1) {
+            simError(line, "expect count sin cantidad");
+        } else if (read == 1 ? count != min : count < min || count > max) {
+            simError(line, "se transmitieron %lu paquetes (se esperaban %s)", count, args);
+        }
+    } else if (strcmp(kind, "last") == 0) {
+        if (count == 0) {
+            simError(line, "no se transmitió ningún paquete");
+        } else if (simPackets.back().text.find(args) == std::string::npos) {
+            simError(line, "el último paquete es %s", simPackets.back().text.c_str());
+        }
+    } else if (strcmp(kind, "interval") == 0) {
+        unsigned long ms = 0, tolerance = 0;
+        if (sscanf(args, "%lu %lu", &ms, &tolerance) < 2) {
+            simError(line, "expect interval sin período o tolerancia");
+            return;
+        }
+        for (size_t i = simIntervalFrom + 1; i < count; i++) {
+            long error = (long)(simPackets[i].ms - simPackets[i - 1].ms) - (long)ms;
+            if (labs(error) > (long)tolerance) {
+                simError(line, "paquetes %lu y %lu separados %llu ms", (unsigned long)i - 1, (unsigned long)i,
+                         simPackets[i].ms - simPackets[i - 1].ms);
+                break;
+            }
+        }
+        simIntervalFrom = count;
+    } else {
+        simError(line, "verificación desconocida: %s", kind);
+    }
+}
+
+/**
+    simApply() aplica una línea del escenario.
+*/
+static void simApply(const SimLine &line) {
+    const char *args = line.args.c_str();
+    if (line.command == "ct") {
+        simCtPeak = atoi(args);
+    } else if (line.command == "rain") {
+        nativeSetAnalog(LLUVIA_PIN, atoi(args));
+    } else if (line.command == "echo") {
+        nativeSetEchoTime((unsigned int)atoi(args));
+    } else if (line.command == "gps") {
+        simGpsOn = strcmp(args, "off") != 0;
+        simGpsFix = simGpsOn && strcmp(args, "nofix") != 0;
+        if (simGpsFix && sscanf(args, "%lf %lf %lf", &simLat, &simLng, &simAlt) < 3) {
+            simError(line, "gps necesita latitud, longitud y altitud");
+        }
+    } else if (line.command == "downlink") {
+        if (!SX1278.injectPacket((const uint8_t *)args, (uint8_t)line.args.size())) {
+            fprintf(stderr, "[%llu ms] downlink perdido (el SX1278 no está en recepción)\n", line.ns / 1000000ULL);
+        }
+    } else if (line.command == "expect") {
+        simExpect(line);
+    } else if (line.command != "end") {
+        simError(line, "comando desconocido: %s", line.command.c_str());
+    }
+}
+
+/**
+    SimScript aplica cada línea del escenario en su instante.
+*/
+class SimScript : public NativeTicker {
+public:
+    SimScript() : _index(0) {}
+
+    virtual unsigned long long nextEvent() { return _index < simLines.size() ? simLines[_index].ns : NATIVE_NEVER; }
+
+    virtual void onEvent(unsigned long long now) {
+        (void)now;
+        const SimLine &line = simLines[_index++];                               // Antes de aplicarla: puede anidar eventos.
+        simApply(line);
+    }
+
+private:
+    size_t _index;
+};
+
+static SimGps simGps;
+static SimScript simScript;
+
+/**
+    simRecord() registra (y lista, salvo -q) cada paquete transmitido por el nodo.
+*/
+static void simRecord(const NativeLoRaPacket &packet) {
+    SimPacket record;
+    record.ms = packet.startUs / 1000ULL;
+    bool ascii = true;
+    for (int i = 0; i < packet.length; i++) {
+        ascii = ascii && packet.data[i] >= 32 && packet.data[i] < 127;
+    }
+    char hex[4];
+    for (int i = 0; i < packet.length; i++) {
+        if (ascii) {
+            record.text += (char)packet.data[i];
+        } else {
+            snprintf(hex, sizeof(hex), "%02X", packet.data[i]);
+            record.text += hex;
+        }
+    }
+    simPackets.push_back(record);
+    if (!simQuiet) {
+        printf("[%llu.%03llu s] %u bytes, %lu us: %s\n", record.ms / 1000ULL, record.ms % 1000ULL,
+               packet.length, packet.airtimeUs, record.text.c_str());
+    }
+}
+
+/**
+    simDeadline() acota el próximo salto a un vencimiento.
+    @param &next Próximo salto (en ns).
+    @param remaining Tiempo hasta el vencimiento (0 o menos si ya venció).
+    @param unit Unidad de remaining y resolución del reloj que lo mide (en ns: 1000000 para
+    millis(), 1000 para micros()).
+*/
+static void simDeadline(unsigned long long &next, int32_t remaining, unsigned long long unit) {
+    unsigned long long now = nativeNanos();
+    unsigned long long deadline = remaining > 0 ? now - now % unit + remaining * unit : now;
+    if (deadline < next) {
+        next = deadline;
+    }
+}
+
+/**
+    simReady() determina si el firmware tiene trabajo que no espera a ningún modelo ni vencimiento:
+    un evento listo para su manejador o un paquete LoRa recién transmitido. No incluye los
+    caracteres del GPS (ver simGpsReady()).
+*/
+static bool simReady() {
+    bool alerting = eventsAny(events, eventBit(EVENT_ALERT) | eventBit(EVENT_BUZZER));
+    uint8_t ready = eventBit(EVENT_DOWNLINK) | eventBit(EVENT_COMMAND);
+    if (!alerting) {                                                            // Si no, esperan a TASK_BUZZER.
+        ready |= eventBit(EVENT_RAIN);
+        #if ADC_SAMPLING != ADC_SAMPLING_ENGINE || defined(CORRIENTE_MOCK)
+            ready |= eventBit(EVENT_CURRENT);
+        #endif
+        #ifndef GAS_MOCK
+            if (gasState == GAS_IDLE || (gasState == GAS_ECHO && pingDone)) {    // Si no, espera el eco o la pausa.
+                ready |= eventBit(EVENT_GAS);
+            }
+        #else
+            ready |= eventBit(EVENT_GAS);
+        #endif
+    }
+    if (!eventPending(events, EVENT_BUZZER)) {
+        ready |= eventBit(EVENT_ALERT);
+    }
+    #ifdef GPS_MOCK
+        ready |= eventBit(EVENT_GPS);
+    #endif
+    if (eventsAny(events, ready) || LoRaTxState == TX_DONE) {
+        return true;
+    }
+    #if PROFILER && PROFILER_UPLINK
+        if (profileUplinkRequested && LoRaTxState == TX_IDLE) {
+            return true;
+        }
+    #endif
+    return false;
+}
+
+/**
+    simGpsReady() determina si hay que vaciar la recepción del GPS: si ya se llenó la mitad
+    del anillo o si llegaron todos los caracteres que envió el GPS. Con GPS_MOCK, el firmware
+    no los lee.
+*/
+static bool simGpsReady() {
+    #if defined(GPS_MOCK)
+        return false;
+    #elif GPS_UART == GPS_UART_CAPTURE
+        uint8_t queued = gpsHead - gpsTail;
+        return queued >= GPS_RING_SIZE / 2 || (queued > 0 && GPSWire.pending() == 0);
+    #else
+        int queued = ssGPS.available();
+        return queued >= _SS_MAX_RX_BUFF / 2 || (queued > 0 && ssGPS.pending() == 0);
+    #endif
+}
+
+/**
+    simNextPass() determina hasta cuándo puede esperar la próxima pasada de loop(): el firmware
+    tiene que volver a ejecutarse en cuanto tenga trabajo (ver simReady() y simGpsReady()),
+    venza una tarea o un tiempo de sensors.h o power.h, o haya que vaciar el anillo del ADC.
+    @param &measuring true si hay una medición de corriente en curso (el motor del ADC debe seguir).
+    @return Instante de la próxima pasada (nativeNanos() si debe ser inmediata).
+*/
+static unsigned long long simNextPass(bool &measuring) {
+    unsigned long long now = nativeNanos();
+    bool alerting = eventsAny(events, eventBit(EVENT_ALERT) | eventBit(EVENT_BUZZER));
+    measuring = false;
+    if (simReady() || simGpsReady()) {
+        return now;
+    }
+
+    unsigned long long next = min(simEnd, now + SIM_MAX_SKIP_NS);
+    uint32_t idle = schedulerIdle(scheduler, millis());
+    if (idle != SCHEDULER_NEVER) {
+        simDeadline(next, (int32_t)idle, 1000000ULL);
+    }
+    if (LoRaTxState == TX_BUSY) {
+        simDeadline(next, (int32_t)(LoRaTxMillis + LORA_TX_TIMEOUT - millis()), 1000000ULL);
+    }
+    #if LORA_RX_WINDOW > 0
+        if (radioMode == RADIO_RX && LoRaTxState == TX_IDLE) {
+            simDeadline(next, (int32_t)(radioMillis + LORA_RX_WINDOW - millis()), 1000000ULL);
+        }
+    #endif
+    #if GPS_POWER_SAVE
+        if (eventPending(events, EVENT_GPS)) {
+            simDeadline(next, (int32_t)(GPSRequestMillis + GPS_FIX_TIMEOUT - millis()), 1000000ULL);
+        }
+    #endif
+    #ifndef GAS_MOCK
+        if (eventPending(events, EVENT_GAS) && !alerting) {
+            simDeadline(next, (int32_t)(pingMicros + PING_MEDIAN_DELAY - micros()), 1000ULL);
+        }
+    #endif
+
+    // SoftwareSerial no avisa la llegada de cada carácter (ver simGpsReady()).
+    #if GPS_UART == GPS_UART_SOFTWARE
+        if (ssGPS.pending() > 0) {
+            next = min(next, now + (_SS_MAX_RX_BUFF / 2) * 10000000000ULL / GPS_BPS);
+        }
+    #endif
+
+    // Las muestras de la medición de corriente en curso: basta con una pasada antes de que se llene el anillo.
+    #if ADC_SAMPLING == ADC_SAMPLING_ENGINE && !defined(CORRIENTE_MOCK)
+        if (eventPending(events, EVENT_CURRENT) && !alerting) {
+            measuring = true;
+            next = min(next, now + (ADC_RING_SIZE / 2) * ADC_CHANNELS_QTY * 1000000000ULL / ADC_SAMPLE_RATE);
+        }
+    #endif
+    return max(next, now);
+}
+
+/**
+    simWait() avanza el reloj hasta la próxima pasada de loop(), de a un evento de los modelos:
+    las interrupciones se atienden en el camino y la espera termina antes si alguna deja trabajo
+    (ver simReady() y simGpsReady()) o si el GPS empieza a enviar por SoftwareSerial. Sin una medición de corriente en curso, saltea los modelos de fondo.
+    @param next Instante de la próxima pasada (ver simNextPass()).
+    @param measuring true si hay una medición de corriente en curso.
+*/
+static void simWait(unsigned long long next, bool measuring) {
+    #if GPS_UART == GPS_UART_SOFTWARE
+        bool feeding = ssGPS.pending() > 0;                                     // Si no, next no tiene en cuenta al GPS.
+    #endif
+    while (nativeNanos() < next) {
+        unsigned long long step = min(next, nativeNextEvent());
+        if (measuring) {
+            nativeAdvanceTo(step);
+        } else {
+            nativeSkipTo(step);
+        }
+        if (simReady() || simGpsReady()) {
+            break;
+        }
+        #if GPS_UART == GPS_UART_SOFTWARE
+            if (!feeding && ssGPS.pending() > 0) {
+                break;
+            }
+        #endif
+    }
+}
+
+int main(int argc, char **argv) {
+    const char *path = NULL;
+    bool verbose = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-q") == 0) {
+            simQuiet = true;
+        } else if (strcmp(argv[i], "-v") == 0) {
+            verbose = true;
+        } else {
+            path = argv[i];
+        }
+    }
+    if (!path) {
+        fprintf(stderr, "Uso: %s escenario.sim [-q] [-v]\n", argv[0]);
+        return 2;
+    }
+    if (!simLoad(path)) {
+        return 2;
+    }
+    for (size_t i = 0; i < simLines.size(); i++) {
+        simEnd = simLines[i].ns;
+        if (simLines[i].command == "end") {
+            break;
+        }
+    }
+
+    Serial.setEcho(verbose);
+    nativeSetAnalogSource(CORRIENTE_PIN, simCurrent);
+    SX1278.onTransmit(simRecord);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    nativeSetMillisOffset(SIM_MILLIS_START);
+    setup();
+    unsigned long long passes = 0, skipped = 0;
+    while (nativeNanos() < simEnd) {
+        loop();
+        nativeAdvance(SIM_LOOP_COST_NS);
+        passes++;
+
+        bool measuring;
+        unsigned long long now = nativeNanos();
+        unsigned long long next = simNextPass(measuring);
+        simWait(next, measuring);
+        skipped += nativeNanos() - now;
+        #if POWER_SAVE != POWER_SAVE_OFF
+            powerIdleMicros += (unsigned long)((nativeNanos() - now) / 1000ULL);
+        #endif
+    }
+    nativeAdvanceTo(simEnd);                                                    // Aplica las líneas del instante final.
+
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fflush(stdout);
+    fprintf(stderr, "%.0f s simulados en %.2f s: %lu paquetes, %llu pasadas de loop() (%.1f%% del tiempo salteado)\n",
+            simEnd / 1e9, wall, (unsigned long)simPackets.size(), passes, simEnd > 0 ? 100.0 * skipped / simEnd : 0.0);
+    if (simErrors > 0) {
+        fprintf(stderr, "%d verificaciones fallidas\n", simErrors);
+        return 1;
+    }
+    return 0;
+}
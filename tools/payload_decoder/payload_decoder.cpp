@@ -0,0 +1,162 @@
+/**
+    Decodificador de payloads binarios para el concentrador LoRa (o cualquier host).
+    Lee paquetes en hexadecimal (uno por línea, por stdin o como argumentos) y los
+    reescribe en el mismo formato que el payload ASCII del nodo, por ejemplo:
+        $ echo 294E410025843D3ECBFF602A59000F00 | ./payload_decoder -c 12
+        <20009>current=0.65&raindrops=1&gas=6.21/12&lat=-34.57475&lng=58.43552&alt=15
+    Así, el parser existente del concentrador sigue funcionando sin cambios.
+    Los payloads agrupados (varias ventanas por paquete) se reescriben igual que el payload
+    ASCII agrupado del nodo:
+        <20009>batch=2&lat=-34.57475&lng=58.43552&alt=15|t=-20&current=0.65&...|t=0&current=0.70&...
+    Los payloads con estadísticas de corriente agregan imin, imax e isd después de current,
+    igual que el payload ASCII con REPORT_CURRENT_STATS.
+    Compilación (desde la raíz del repositorio):
+        g++ -std=c++11 -Iinclude tools/payload_decoder/payload_decoder.cpp -o payload_decoder
+    @file payload_decoder.cpp
+    @author Franco Abosso
+    @author Julio Donadello
+    @version 1.1 16/10/2026
+*/
+
+#include "binary_payload.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+/**
+    hexToBytes() convierte una string hexadecimal (se ignoran espacios) en bytes.
+    @return Cantidad de bytes convertidos, o -1 si la string es inválida.
+*/
+static int hexToBytes(const char *hex, uint8_t out[], size_t size) {
+    size_t count = 0;
+    int high = -1;
+    for (; *hex; hex++) {
+        if (isspace((unsigned char)*hex)) {
+            continue;
+        }
+        if (!isxdigit((unsigned char)*hex) || count >= size) {
+            return -1;
+        }
+        int nibble = isdigit((unsigned char)*hex) ? *hex - '0' : toupper((unsigned char)*hex) - 'A' + 10;
+        if (high < 0) {
+            high = nibble;
+        } else {
+            out[count++] = (uint8_t)(high << 4 | nibble);
+            high = -1;
+        }
+    }
+    return high < 0 ? (int)count : -1;
+}
+
+/**
+    printCentiamps() imprime una corriente en centiamperes en amperes, con 2 decimales
+    ("nan" si es BINARY_PAYLOAD_NO_CURRENT), igual que printCentiamps() del nodo.
+*/
+static void printCentiamps(uint16_t centiamps) {
+    if (centiamps == BINARY_PAYLOAD_NO_CURRENT) {
+        printf("nan");
+    } else {
+        printf("%.2f", centiamps / 100.0);
+    }
+}
+
+/**
+    printWindow() imprime los campos de una ventana (corriente, lluvia y combustible)
+    con el formato del payload ASCII.
+    Si la ventana trae estadísticas (versiones BINARY_PAYLOAD_STATS_VERSION y
+    BINARY_BATCH_STATS_VERSION), la corriente media va seguida de la mínima, la máxima
+    y el desvío estándar ("current=0.65&imin=0.60&imax=0.71&isd=0.03"), como con
+    REPORT_CURRENT_STATS en el nodo.
+    Si no se conoce la capacidad del tanque, el combustible se expresa como fracción ("gas=0.82/1").
+*/
+static void printWindow(uint16_t current, bool stats, uint16_t currentMin, uint16_t currentMax,
+                        uint16_t currentStddev, int8_t rain, uint8_t gas, double capacity) {
+    printf("current=");
+    printCentiamps(current);
+    if (stats) {
+        printf("&imin=");
+        printCentiamps(currentMin);
+        printf("&imax=");
+        printCentiamps(currentMax);
+        printf("&isd=");
+        printCentiamps(currentStddev);
+    }
+    printf("&raindrops=%d", rain);
+    if (capacity > 0) {
+        printf("&gas=%.2f/%g", capacity * gas / BINARY_PAYLOAD_FUEL_FULL, capacity);
+    } else {
+        printf("&gas=%.2f/1", (double)gas / BINARY_PAYLOAD_FUEL_FULL);
+    }
+}
+
+/**
+    printPosition() imprime la posición de un BinaryPayload con el formato del payload ASCII.
+*/
+static void printPosition(const BinaryPayload &payload) {
+    if (payload.gpsValid) {
+        printf("&lat=%.5f&lng=%.5f&alt=%d",
+               (double)payload.lat / BINARY_PAYLOAD_GPS_SCALE,
+               (double)payload.lng / BINARY_PAYLOAD_GPS_SCALE,
+               payload.alt);
+    } else {
+        printf("&lat=***&lng=***&alt=***");
+    }
+}
+
+static bool decodeLine(const char *line, double capacity) {
+    uint8_t buffer[256];
+    BinaryPayload payload;
+    BinaryBatchWindow windows[BINARY_BATCH_MAX_WINDOWS];
+    uint8_t count;
+    int size = hexToBytes(line, buffer, sizeof(buffer));
+    if (size < 0) {
+        fprintf(stderr, "Payload inválido: %s\n", line);
+        return false;
+    }
+    if (decodeBinaryPayload(buffer, (size_t)size, payload)) {
+        printf("<%u>", (unsigned)payload.deviceId);
+        printWindow(payload.current, payload.stats, payload.currentMin, payload.currentMax,
+                    payload.currentStddev, payload.rain, payload.gas, capacity);
+        printPosition(payload);
+    } else if (decodeBinaryBatch(buffer, (size_t)size, payload, windows, count)) {
+        printf("<%u>batch=%u", (unsigned)payload.deviceId, (unsigned)count);
+        printPosition(payload);
+        for (uint8_t i = 0; i < count; i++) {
+            printf("|t=%ld&", -(long)windows[i].age);
+            printWindow(windows[i].current, payload.stats, windows[i].currentMin, windows[i].currentMax,
+                        windows[i].currentStddev, windows[i].rain, windows[i].gas, capacity);
+        }
+    } else {
+        fprintf(stderr, "Payload inválido: %s\n", line);
+        return false;
+    }
+    printf("\n");
+    return true;
+}
+
+int main(int argc, char **argv) {
+    double capacity = 0;
+    int first = 1;
+    if (argc > 2 && strcmp(argv[1], "-c") == 0) {
+        capacity = atof(argv[2]);
+        first = 3;
+    }
+
+    bool ok = true;
+    if (first < argc) {
+        for (int i = first; i < argc; i++) {
+            ok = decodeLine(argv[i], capacity) && ok;
+        }
+    } else {
+        char line[1024];
+        while (fgets(line, sizeof(line), stdin)) {
+            line[strcspn(line, "\r\n")] = 0;
+            if (line[0]) {
+                ok = decodeLine(line, capacity) && ok;
+            }
+        }
+    }
+    return ok ? 0 : 1;
+}